@@ -24,7 +24,6 @@
 
 #include "widget.h"
 #include "../../framelesshelper.h"
-#include <QEvent>
 #include <QGraphicsDropShadowEffect>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -72,7 +71,6 @@ Widget::Widget(QWidget *parent) : QWidget(parent)
     createWinId();
     setupUi();
     initBackgroundWindow();
-    installEventFilter(this);
 }
 
 bool Widget::isNormal() const
@@ -198,6 +196,33 @@ void Widget::initBackgroundWindow()
     contentsWidget->setGraphicsEffect(shadowEffect);
     setFrameShadowEnabled();
     setFrameShadowActive();
+    // The helper watches the window anyway, no need for another event filter.
+    connect(framelessHelper(),
+            &FramelessHelper::windowStateChanged,
+            this,
+            [this](QWindow *window, Qt::WindowState state) {
+                if (window != windowHandle()) {
+                    return;
+                }
+                const bool normal = (state == Qt::WindowNoState);
+                contentsWidget->setShouldDrawWindowBorder(normal);
+                setFrameShadowEnabled(normal);
+                framelessHelper()->setTitleBarHeight(
+                    titleBarHeight + (normal ? framelessHelper()->getBorderHeight() : 0));
+                const QString maxIconPath = QString::fromUtf8(
+                    ":/images/button_maximize_black.svg");
+                const QString restoreIconPath = QString::fromUtf8(
+                    ":/images/button_restore_black.svg");
+                maximizeButton->setIcon(QIcon(normal ? maxIconPath : restoreIconPath));
+            });
+    connect(framelessHelper(),
+            &FramelessHelper::activeChanged,
+            this,
+            [this](QWindow *window, bool active) {
+                if ((window == windowHandle()) && isNormal()) {
+                    setFrameShadowActive(active);
+                }
+            });
 }
 
 void Widget::setFrameShadowEnabled(const bool enable)
@@ -223,36 +248,3 @@ void Widget::setFrameShadowActive(const bool active)
         shadowEffect->setBlurRadius(20);
     }
 }
-
-bool Widget::eventFilter(QObject *object, QEvent *event)
-{
-    Q_ASSERT(object);
-    Q_ASSERT(event);
-    if (object == this) {
-        switch (event->type()) {
-        case QEvent::WindowStateChange: {
-            const bool normal = isNormal();
-            contentsWidget->setShouldDrawWindowBorder(normal);
-            setFrameShadowEnabled(normal);
-            framelessHelper()->setTitleBarHeight(
-                titleBarHeight + (normal ? framelessHelper()->getBorderHeight() : 0));
-            const QString maxIconPath = QString::fromUtf8(":/images/button_maximize_black.svg");
-            const QString restoreIconPath = QString::fromUtf8(":/images/button_restore_black.svg");
-            maximizeButton->setIcon(QIcon(normal ? maxIconPath : restoreIconPath));
-        } break;
-        case QEvent::WindowActivate: {
-            if (isNormal()) {
-                setFrameShadowActive();
-            }
-        } break;
-        case QEvent::WindowDeactivate: {
-            if (isNormal()) {
-                setFrameShadowActive(false);
-            }
-        } break;
-        default:
-            break;
-        }
-    }
-    return QWidget::eventFilter(object, event);
-}
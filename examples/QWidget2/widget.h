@@ -70,9 +70,6 @@ public:
 
     bool isNormal() const;
 
-protected:
-    bool eventFilter(QObject *object, QEvent *event) override;
-
 private:
     void setupUi();
     void initBackgroundWindow();
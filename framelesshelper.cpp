@@ -25,13 +25,219 @@
 #include "framelesshelper.h"
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+#include "hittestengine.h"
+#include "screentopology.h"
 #include <QDebug>
 #include <QEvent>
+#include <QGuiApplication>
+#include <QHash>
+#include <QKeyEvent>
 #include <QMouseEvent>
+#include <QResizeEvent>
+#include <QStyleHints>
 #include <QTouchEvent>
+#include <QVarLengthArray>
 #include <QWindow>
 
-FramelessHelper::FramelessHelper(QObject *parent) : QObject(parent) {}
+namespace {
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+using TouchPoint = QEventPoint;
+#else
+using TouchPoint = QTouchEvent::TouchPoint;
+#endif
+
+TouchGestureRecognizer::PointState getPointState(const TouchPoint &touchPoint)
+{
+    // QEventPoint::State has the same values as Qt::TouchPointState.
+    switch (static_cast<Qt::TouchPointState>(touchPoint.state())) {
+    case Qt::TouchPointPressed:
+        return TouchGestureRecognizer::PointState::Pressed;
+    case Qt::TouchPointMoved:
+        return TouchGestureRecognizer::PointState::Moved;
+    case Qt::TouchPointReleased:
+        return TouchGestureRecognizer::PointState::Released;
+    default:
+        break;
+    }
+    return TouchGestureRecognizer::PointState::Stationary;
+}
+
+// The touch gestures are handled on their own, don't handle them a second
+// time through the mouse events Qt synthesizes from them.
+bool isSynthesizedFromTouch(const QMouseEvent *event)
+{
+    Q_ASSERT(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    return event->deviceType() == QInputDevice::DeviceType::TouchScreen;
+#else
+    return event->source() == Qt::MouseEventSynthesizedByQt;
+#endif
+}
+
+// What startSystemMove() and startSystemResize() told us so far, per platform
+// plugin. The first answer decides: a platform which refuses it is not asked
+// again, we go straight to our own implementation, until the screens change
+// (another screen may be managed differently), see
+// invalidatePlatformCapabilities(). Once a call has worked, a refusal only
+// means that the window manager didn't like this particular press (or that
+// the button has been released in the meantime), so it keeps being asked.
+enum class PlatformCapability { Unknown, Supported, Unsupported };
+
+struct PlatformCapabilities
+{
+    PlatformCapability systemMove = PlatformCapability::Unknown;
+    PlatformCapability systemResize = PlatformCapability::Unknown;
+};
+
+using PlatformCapabilitiesHash = QHash<QString, PlatformCapabilities>;
+Q_GLOBAL_STATIC(PlatformCapabilitiesHash, platformCapabilitiesHash)
+
+PlatformCapabilities &getPlatformCapabilities()
+{
+    return (*platformCapabilitiesHash())[QGuiApplication::platformName()];
+}
+
+void invalidatePlatformCapabilities()
+{
+    platformCapabilitiesHash()->clear();
+}
+
+// Asks the platform unless it has already refused "start" before, and
+// remembers the answer.
+template<typename Start>
+bool probePlatformCapability(PlatformCapability &capability, const Start &start)
+{
+    if (capability == PlatformCapability::Unsupported) {
+        return false;
+    }
+    if (start()) {
+        capability = PlatformCapability::Supported;
+        return true;
+    }
+    if (capability == PlatformCapability::Unknown) {
+        capability = PlatformCapability::Unsupported;
+    }
+    return false;
+}
+
+// The geometry of a window being moved by "region" (Caption) or resized by
+// one of its edges, "delta" away from where the gesture started.
+QRect getManualGeometry(const HitTestEngine::Region region,
+                        const QRect &geometry,
+                        const QPoint &delta,
+                        const QSize &minimumSize,
+                        const QSize &maximumSize)
+{
+    if (region == HitTestEngine::Region::Caption) {
+        return geometry.translated(delta);
+    }
+    const Qt::Edges edges = HitTestEngine::toEdges(region);
+    QRect ret = geometry;
+    if (edges.testFlag(Qt::LeftEdge)) {
+        const int width = qBound(minimumSize.width(),
+                                 geometry.width() - delta.x(),
+                                 maximumSize.width());
+        ret.setLeft(geometry.right() + 1 - width);
+    } else if (edges.testFlag(Qt::RightEdge)) {
+        ret.setWidth(qBound(minimumSize.width(), geometry.width() + delta.x(),
+                            maximumSize.width()));
+    }
+    if (edges.testFlag(Qt::TopEdge)) {
+        const int height = qBound(minimumSize.height(),
+                                  geometry.height() - delta.y(),
+                                  maximumSize.height());
+        ret.setTop(geometry.bottom() + 1 - height);
+    } else if (edges.testFlag(Qt::BottomEdge)) {
+        ret.setHeight(qBound(minimumSize.height(), geometry.height() + delta.y(),
+                             maximumSize.height()));
+    }
+    return ret;
+}
+
+QPointF getMousePos(const QMouseEvent *event, const bool global)
+{
+    Q_ASSERT(event);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    return global ? event->globalPosition() : event->scenePosition();
+#else
+    return global ? event->screenPos() : event->windowPos();
+#endif
+}
+
+// Most of the events a window gets (paint, expose, update requests, key
+// and input method events, ...) are of no interest to us. The event filter
+// looks the type up in this table before doing anything else.
+enum EventFlag : quint8 {
+    Ignored = 0,
+    // Only while the window is visible and not minimized.
+    Interactive = 1,
+    // Keeps the state of the window up to date, always needed.
+    Lifecycle = 2
+};
+
+// All the built-in types we handle are way below that.
+constexpr int m_eventTableSize = 256;
+
+struct EventTable
+{
+    quint8 flags[m_eventTableSize] = {};
+};
+
+constexpr EventTable getEventTable()
+{
+    EventTable table = {};
+    table.flags[QEvent::MouseButtonPress] = Interactive;
+    table.flags[QEvent::MouseButtonRelease] = Interactive;
+    table.flags[QEvent::MouseButtonDblClick] = Interactive;
+    table.flags[QEvent::MouseMove] = Interactive;
+    table.flags[QEvent::KeyPress] = Interactive;
+    table.flags[QEvent::Leave] = Interactive;
+    table.flags[QEvent::TouchBegin] = Interactive;
+    table.flags[QEvent::TouchUpdate] = Interactive;
+    table.flags[QEvent::TouchEnd] = Interactive;
+    table.flags[QEvent::TouchCancel] = Interactive;
+    table.flags[QEvent::Show] = Lifecycle;
+    table.flags[QEvent::Hide] = Lifecycle;
+    table.flags[QEvent::Resize] = Lifecycle;
+    table.flags[QEvent::WindowStateChange] = Lifecycle;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
+    table.flags[QEvent::DevicePixelRatioChange] = Lifecycle;
+#endif
+    return table;
+}
+
+constexpr EventTable m_eventTable = getEventTable();
+
+Qt::WindowState getWindowState(const Qt::WindowStates states)
+{
+    if (states.testFlag(Qt::WindowFullScreen)) {
+        return Qt::WindowFullScreen;
+    }
+    if (states.testFlag(Qt::WindowMaximized)) {
+        return Qt::WindowMaximized;
+    }
+    if (states.testFlag(Qt::WindowMinimized)) {
+        return Qt::WindowMinimized;
+    }
+    return Qt::WindowNoState;
+}
+
+bool isWindowActive(const QWindow *window)
+{
+    Q_ASSERT(window);
+    return window->isVisible() && !window->windowStates().testFlag(Qt::WindowMinimized);
+}
+
+} // namespace
+
+FramelessHelper::FramelessHelper(QObject *parent) : QObject(parent)
+{
+    // Another screen may be managed by another window manager, or by one
+    // which can move and resize windows after all.
+    connect(qApp, &QGuiApplication::screenAdded, this, [] { invalidatePlatformCapabilities(); });
+    connect(qApp, &QGuiApplication::screenRemoved, this, [] { invalidatePlatformCapabilities(); });
+}
 
 int FramelessHelper::getBorderWidth() const
 {
@@ -41,6 +247,22 @@ int FramelessHelper::getBorderWidth() const
 void FramelessHelper::setBorderWidth(const int val)
 {
     m_borderWidth = val;
+    m_windowStates.forEach([this](const QWindow *, WindowState &state) { updateMetrics(state); });
+}
+
+int FramelessHelper::getBorderWidth(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return (state && (state->borderWidth >= 0)) ? state->borderWidth : m_borderWidth;
+}
+
+void FramelessHelper::setBorderWidth(const QWindow *window, const int val)
+{
+    Q_ASSERT(window);
+    WindowState &state = getOrCreateWindowState(window);
+    state.borderWidth = val;
+    updateMetrics(state);
 }
 
 int FramelessHelper::getBorderHeight() const
@@ -51,6 +273,22 @@ int FramelessHelper::getBorderHeight() const
 void FramelessHelper::setBorderHeight(const int val)
 {
     m_borderHeight = val;
+    m_windowStates.forEach([this](const QWindow *, WindowState &state) { updateMetrics(state); });
+}
+
+int FramelessHelper::getBorderHeight(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return (state && (state->borderHeight >= 0)) ? state->borderHeight : m_borderHeight;
+}
+
+void FramelessHelper::setBorderHeight(const QWindow *window, const int val)
+{
+    Q_ASSERT(window);
+    WindowState &state = getOrCreateWindowState(window);
+    state.borderHeight = val;
+    updateMetrics(state);
 }
 
 int FramelessHelper::getTitleBarHeight() const
@@ -61,183 +299,774 @@ int FramelessHelper::getTitleBarHeight() const
 void FramelessHelper::setTitleBarHeight(const int val)
 {
     m_titleBarHeight = val;
+    m_windowStates.forEach([this](const QWindow *, WindowState &state) { updateMetrics(state); });
 }
 
-QObjectList FramelessHelper::getIgnoreObjects(const QWindow *window) const
+int FramelessHelper::getTitleBarHeight(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return (state && (state->titleBarHeight >= 0)) ? state->titleBarHeight : m_titleBarHeight;
+}
+
+void FramelessHelper::setTitleBarHeight(const QWindow *window, const int val)
+{
+    Q_ASSERT(window);
+    WindowState &state = getOrCreateWindowState(window);
+    state.titleBarHeight = val;
+    updateMetrics(state);
+}
+
+int FramelessHelper::getDragDistance() const
+{
+    return (m_dragDistance >= 0) ? m_dragDistance
+                                 : QGuiApplication::styleHints()->startDragDistance();
+}
+
+void FramelessHelper::setDragDistance(const int val)
+{
+    m_dragDistance = val;
+}
+
+int FramelessHelper::getDragTime() const
+{
+    return (m_dragTime >= 0) ? m_dragTime : QGuiApplication::styleHints()->startDragTime();
+}
+
+void FramelessHelper::setDragTime(const int val)
+{
+    m_dragTime = val;
+}
+
+HitTestEngine::Metrics FramelessHelper::getHitTestMetrics(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    HitTestEngine::Metrics metrics = {};
+    metrics.windowWidth = window->width();
+    metrics.windowHeight = window->height();
+    metrics.borderWidth = m_borderWidth;
+    metrics.borderHeight = m_borderHeight;
+    metrics.titleBarHeight = m_titleBarHeight;
+    metrics.maximized = !window->windowStates().testFlag(Qt::WindowState::WindowNoState);
+    return metrics;
+}
+
+void FramelessHelper::resetMetrics(const QWindow *window, WindowState &state) const
 {
     Q_ASSERT(window);
-    QObjectList ret{};
-    const QObjectList objs = m_ignoreObjects.value(window);
-    if (!objs.isEmpty()) {
-        for (auto &&_obj : qAsConst(objs)) {
-            if (_obj) {
-                ret.append(_obj);
+    state.size = window->size();
+    state.devicePixelRatio = window->devicePixelRatio();
+    state.metrics.maximized = !window->windowStates().testFlag(Qt::WindowState::WindowNoState);
+    updateMetrics(state);
+}
+
+void FramelessHelper::updateMetrics(WindowState &state) const
+{
+    const qreal dpr = state.devicePixelRatio;
+    const auto toDevicePixels = [dpr](const int val) { return qRound(val * dpr); };
+    state.metrics.windowWidth = toDevicePixels(state.size.width());
+    state.metrics.windowHeight = toDevicePixels(state.size.height());
+    state.metrics.borderWidth = toDevicePixels((state.borderWidth >= 0) ? state.borderWidth
+                                                                        : m_borderWidth);
+    state.metrics.borderHeight = toDevicePixels((state.borderHeight >= 0) ? state.borderHeight
+                                                                          : m_borderHeight);
+    state.metrics.titleBarHeight = toDevicePixels(
+        (state.titleBarHeight >= 0) ? state.titleBarHeight : m_titleBarHeight);
+    state.hitTestCache.clear();
+}
+
+FramelessHelper::WindowState &FramelessHelper::getOrCreateWindowState(const QWindow *window)
+{
+    Q_ASSERT(window);
+    bool inserted = false;
+    WindowState &state = m_windowStates.findOrInsert(window, &inserted);
+    if (inserted) {
+        resetMetrics(window, state);
+        // A new screen may come with another device pixel ratio. Qt 6 also
+        // tells the window when the ratio of its screen changes, see
+        // eventFilter().
+        connect(window, &QWindow::screenChanged, this, [this, window] {
+            invalidatePlatformCapabilities();
+            WindowState *state = m_windowStates.find(window);
+            if (state) {
+                resetMetrics(window, *state);
             }
-        }
+        });
+        // The focus events also come and go with popups and child windows,
+        // only the activation of the window itself matters.
+        connect(window, &QWindow::activeChanged, this, [this, window] {
+            WindowState *state = m_windowStates.find(window);
+            if (!state) {
+                return;
+            }
+            const auto mutableWindow = const_cast<QWindow *>(window);
+            const bool active = window->isActive();
+            if (!active) {
+                // The release will go somewhere else.
+                abortGesture(*state);
+                if (state->manualGesture) {
+                    finishManualGesture(mutableWindow, *state);
+                    // The slots of dragFinished() may have destroyed it.
+                    if (!m_windowStates.find(window)) {
+                        return;
+                    }
+                }
+            }
+            Q_EMIT activeChanged(mutableWindow, active);
+        });
+        // A new window may get the same address, it must not inherit
+        // anything from this one.
+        connect(window, &QObject::destroyed, this, [this, window] {
+            WindowState *state = m_windowStates.find(window);
+            if (state) {
+                setManualUpdatePending(*state, false);
+            }
+            m_windowStates.remove(window);
+        });
     }
-    return ret;
+    return state;
+}
+
+TitleBarAreas *FramelessHelper::getOrCreateTitleBarAreas(const QWindow *window)
+{
+    Q_ASSERT(window);
+    QPointer<TitleBarAreas> &areas = getOrCreateWindowState(window).titleBarAreas;
+    if (!areas) {
+        // The areas watch the geometry of the objects, let them die with the
+        // window they belong to.
+        areas = new TitleBarAreas(const_cast<QWindow *>(window));
+    }
+    return areas;
+}
+
+const TitleBarAreas *FramelessHelper::getTitleBarAreas(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return state ? state->titleBarAreas.data() : nullptr;
+}
+
+QObjectList FramelessHelper::getIgnoreObjects(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->ignoredObjects() : QObjectList{};
 }
 
 void FramelessHelper::addIgnoreObject(const QWindow *window, QObject *val)
 {
     Q_ASSERT(window);
-    QObjectList objs = m_ignoreObjects[window];
-    objs.append(val);
-    m_ignoreObjects[window] = objs;
+    getOrCreateTitleBarAreas(window)->addIgnoredObject(val);
+}
+
+void FramelessHelper::addIgnoreObjects(const QWindow *window, const QObjectList &val)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredObjects(val);
+}
+
+void FramelessHelper::removeIgnoreObject(const QWindow *window, const QObject *val)
+{
+    Q_ASSERT(window);
+    WindowState *state = m_windowStates.find(window);
+    if (state && state->titleBarAreas) {
+        state->titleBarAreas->removeIgnoredObject(val);
+    }
+}
+
+void FramelessHelper::clearIgnoreObjects(const QWindow *window)
+{
+    Q_ASSERT(window);
+    WindowState *state = m_windowStates.find(window);
+    if (state && state->titleBarAreas) {
+        state->titleBarAreas->clearIgnoredObjects();
+    }
+}
+
+void FramelessHelper::addIgnoreRegion(const QWindow *window, const QRegion &region)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredRegion(region);
+}
+
+void FramelessHelper::addIgnorePath(const QWindow *window, const QPainterPath &path)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredPath(path);
+}
+
+QObjectList FramelessHelper::getDragObjects(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->dragObjects() : QObjectList{};
+}
+
+void FramelessHelper::addDragObject(const QWindow *window, QObject *val)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addDragObject(val);
+}
+
+void FramelessHelper::addDragRect(const QWindow *window, const QRectF &rect)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addDragRect(rect);
+}
+
+bool FramelessHelper::isDragAllowListEnabled(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas && areas->isDragAllowListEnabled();
+}
+
+void FramelessHelper::setDragAllowListEnabled(const QWindow *window, const bool val)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setDragAllowListEnabled(val);
+}
+
+bool FramelessHelper::isZOrderHitTestEnabled(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas && areas->isZOrderHitTestEnabled();
+}
+
+void FramelessHelper::setZOrderHitTestEnabled(const QWindow *window, const bool val)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setZOrderHitTestEnabled(val);
 }
 
 bool FramelessHelper::getResizable(const QWindow *window) const
 {
     Q_ASSERT(window);
-    return !m_fixedSize.value(window);
+    const WindowState *state = m_windowStates.find(window);
+    return !(state && state->metrics.fixedSize);
 }
 
 void FramelessHelper::setResizable(const QWindow *window, const bool val)
 {
     Q_ASSERT(window);
-    m_fixedSize[window] = !val;
+    WindowState &state = getOrCreateWindowState(window);
+    state.metrics.fixedSize = !val;
+    state.hitTestCache.clear();
 }
 
-void FramelessHelper::removeWindowFrame(QWindow *window)
+TitleBarRegionMap FramelessHelper::getTitleBarRegionMap(const QWindow *window) const
 {
     Q_ASSERT(window);
-    window->setFlags(Qt::Window | Qt::FramelessWindowHint | Qt::WindowSystemMenuHint
-                     | Qt::WindowMinMaxButtonsHint | Qt::WindowTitleHint);
-    // MouseTracking is always enabled for QWindow.
-    window->installEventFilter(this);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->regionMap() : TitleBarRegionMap{};
 }
 
-bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
+void FramelessHelper::setTitleBarRegionMap(const QWindow *window, const TitleBarRegionMap &map)
 {
-    Q_ASSERT(object);
-    Q_ASSERT(event);
-    if (!object->isWindowType()) {
-        return false;
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setRegionMap(map);
+}
+
+HitTestEngine::Callback FramelessHelper::getHitTestCallback(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->hitTestCallback() : HitTestEngine::Callback{};
+}
+
+void FramelessHelper::setHitTestCallback(const QWindow *window,
+                                         const HitTestEngine::Callback &callback)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setHitTestCallback(callback);
+}
+
+HitTestEngine::Region FramelessHelper::hitTest(const QWindow *window, const QPointF &point) const
+{
+    Q_ASSERT(window);
+    WindowState *state = m_windowStates.find(window);
+    if (state) {
+        return hitTest(window, *state, point);
     }
-    // QWindow will always be a top level window. It can't
-    // be anyone's child window.
-    const auto currentWindow = qobject_cast<QWindow *>(object);
-    static bool m_bIsMRBPressed = false;
-    static QPointF m_pOldMousePos = {};
-    const auto getWindowEdges =
-        [this](const QPointF &point, const int ww, const int wh) -> Qt::Edges {
-        if (point.y() <= m_borderHeight) {
-            if (point.x() <= m_borderWidth) {
-                return Qt::Edge::TopEdge | Qt::Edge::LeftEdge;
-            }
-            if (point.x() >= (ww - m_borderWidth)) {
-                return Qt::Edge::TopEdge | Qt::Edge::RightEdge;
-            }
-            return Qt::Edge::TopEdge;
+    // Not one of our windows, nothing to remember.
+    return HitTestEngine::classify(getHitTestMetrics(window), point.x(), point.y());
+}
+
+HitTestEngine::Region FramelessHelper::hitTest(const QWindow *window,
+                                               WindowState &state,
+                                               const QPointF &point) const
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = state.titleBarAreas;
+    // The metrics setters clear the memo themselves.
+    HitTestEngine::Region region = HitTestEngine::Region::Client;
+    if (areas && areas->hitTestOverride(point, &region)) {
+        return region;
+    }
+    // The z-order aware hit test depends on widgets or items we don't
+    // watch, the generation can't tell when its result is outdated.
+    const bool cacheable = !areas || !areas->isZOrderHitTestEnabled();
+    const quint64 generation = areas ? areas->generation() : 0;
+    if (cacheable && state.hitTestCache.lookup(point.x(), point.y(), generation, &region)) {
+        return region;
+    }
+    const qreal dpr = state.devicePixelRatio;
+    region = HitTestEngine::classify(state.metrics, point.x() * dpr, point.y() * dpr);
+    if (areas) {
+        region = areas->refine(region, state.size.width(), point, dpr);
+    }
+    if (cacheable) {
+        state.hitTestCache.insert(point.x(), point.y(), generation, region);
+    }
+    return region;
+}
+
+QVector<HitTestEngine::Region> FramelessHelper::hitTest(const QWindow *window,
+                                                        const QVector<QPointF> &points) const
+{
+    Q_ASSERT(window);
+    const int count = points.size();
+    QVector<HitTestEngine::Region> regions(count);
+    if (count <= 0) {
+        return regions;
+    }
+    // The engine wants the coordinates as two separate arrays.
+    QVector<qreal> coordinates(count * 2);
+    qreal * const xs = coordinates.data();
+    qreal * const ys = xs + count;
+    const WindowState *state = m_windowStates.find(window);
+    if (!state) {
+        // Not one of our windows, classify in logical pixels.
+        for (int i = 0; i != count; ++i) {
+            xs[i] = points.at(i).x();
+            ys[i] = points.at(i).y();
         }
-        if (point.y() >= (wh - m_borderHeight)) {
-            if (point.x() <= m_borderWidth) {
-                return Qt::Edge::BottomEdge | Qt::Edge::LeftEdge;
-            }
-            if (point.x() >= (ww - m_borderWidth)) {
-                return Qt::Edge::BottomEdge | Qt::Edge::RightEdge;
+        HitTestEngine::classify(getHitTestMetrics(window), xs, ys, regions.data(), count);
+        return regions;
+    }
+    const qreal dpr = state->devicePixelRatio;
+    for (int i = 0; i != count; ++i) {
+        xs[i] = points.at(i).x() * dpr;
+        ys[i] = points.at(i).y() * dpr;
+    }
+    HitTestEngine::classify(state->metrics, xs, ys, regions.data(), count);
+    const TitleBarAreas *areas = state->titleBarAreas;
+    if (areas) {
+        const int windowWidth = state->size.width();
+        for (int i = 0; i != count; ++i) {
+            if (!areas->hitTestOverride(points.at(i), &regions[i])) {
+                regions[i] = areas->refine(regions.at(i), windowWidth, points.at(i), dpr);
             }
-            return Qt::Edge::BottomEdge;
-        }
-        if (point.x() <= m_borderWidth) {
-            return Qt::Edge::LeftEdge;
         }
-        if (point.x() >= (ww - m_borderWidth)) {
-            return Qt::Edge::RightEdge;
-        }
-        return {};
-    };
-    const auto getCursorShape = [](const Qt::Edges edges) -> Qt::CursorShape {
-        if ((edges.testFlag(Qt::Edge::TopEdge) && edges.testFlag(Qt::Edge::LeftEdge))
-            || (edges.testFlag(Qt::Edge::BottomEdge) && edges.testFlag(Qt::Edge::RightEdge))) {
-            return Qt::CursorShape::SizeFDiagCursor;
+    }
+    return regions;
+}
+
+quint64 FramelessHelper::getHitTestCacheHits() const
+{
+    quint64 hits = 0;
+    m_windowStates.forEach([&hits](const QWindow *, const WindowState &state) {
+        hits += state.hitTestCache.hits();
+    });
+    return hits;
+}
+
+quint64 FramelessHelper::getHitTestCacheMisses() const
+{
+    quint64 misses = 0;
+    m_windowStates.forEach([&misses](const QWindow *, const WindowState &state) {
+        misses += state.hitTestCache.misses();
+    });
+    return misses;
+}
+
+quint64 FramelessHelper::getAppliedCursorUpdates() const
+{
+    return m_appliedCursorUpdates;
+}
+
+quint64 FramelessHelper::getSuppressedCursorUpdates() const
+{
+    return m_suppressedCursorUpdates;
+}
+
+void FramelessHelper::updateCursor(QWindow *window,
+                                   WindowState &state,
+                                   const Qt::CursorShape shape)
+{
+    Q_ASSERT(window);
+    // Changing the cursor is a round trip to the windowing system, only do
+    // it when the mouse moves into a region with a different cursor.
+    if (state.cursorShape == shape) {
+        ++m_suppressedCursorUpdates;
+        return;
+    }
+    if (state.cursorShape == Qt::CursorShape::ArrowCursor) {
+        state.applicationCursor = window->cursor();
+    }
+    state.cursorShape = shape;
+    ++m_appliedCursorUpdates;
+    if (shape != Qt::CursorShape::ArrowCursor) {
+        window->setCursor(shape);
+    } else if (state.applicationCursor.shape() == Qt::CursorShape::ArrowCursor) {
+        // Nothing but the default one.
+        window->unsetCursor();
+    } else {
+        window->setCursor(state.applicationCursor);
+    }
+}
+
+FramelessHelper::GestureState FramelessHelper::getGestureState(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return state ? state->gesture : GestureState::Idle;
+}
+
+void FramelessHelper::cancelGesture(const QWindow *window)
+{
+    Q_ASSERT(window);
+    WindowState *state = m_windowStates.find(window);
+    if (state) {
+        abortGesture(*state);
+    }
+}
+
+quint64 FramelessHelper::getStartedGestures() const
+{
+    return m_startedGestures;
+}
+
+quint64 FramelessHelper::getAbortedGestures() const
+{
+    return m_abortedGestures;
+}
+
+quint64 FramelessHelper::getManualGeometryUpdates() const
+{
+    return m_manualGeometryUpdates;
+}
+
+quint64 FramelessHelper::getCoalescedManualMoves() const
+{
+    return m_coalescedManualMoves;
+}
+
+bool FramelessHelper::getConsumeHandledEvents(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return state && state->consumeHandledEvents;
+}
+
+void FramelessHelper::setConsumeHandledEvents(const QWindow *window, const bool val)
+{
+    Q_ASSERT(window);
+    getOrCreateWindowState(window).consumeHandledEvents = val;
+}
+
+bool FramelessHelper::isSnappingEnabled(const QWindow *window) const
+{
+    Q_ASSERT(window);
+    const WindowState *state = m_windowStates.find(window);
+    return state && state->snapping;
+}
+
+void FramelessHelper::setSnappingEnabled(const QWindow *window, const bool val)
+{
+    Q_ASSERT(window);
+    getOrCreateWindowState(window).snapping = val;
+}
+
+int FramelessHelper::getSnapDistance() const
+{
+    return m_snapDistance;
+}
+
+void FramelessHelper::setSnapDistance(const int val)
+{
+    m_snapDistance = val;
+}
+
+ScreenTopology *FramelessHelper::getScreenTopology()
+{
+    if (!m_screenTopology) {
+        m_screenTopology = new ScreenTopology(this);
+    }
+    return m_screenTopology;
+}
+
+bool FramelessHelper::startSystemMoveOrResize(QWindow *window, const HitTestEngine::Region region)
+{
+    Q_ASSERT(window);
+    PlatformCapabilities &capabilities = getPlatformCapabilities();
+    if (region == HitTestEngine::Region::Caption) {
+        const bool wasUnknown = (capabilities.systemMove == PlatformCapability::Unknown);
+        if (probePlatformCapability(capabilities.systemMove,
+                                    [window] { return window->startSystemMove(); })) {
+            return true;
         }
-        if ((edges.testFlag(Qt::Edge::TopEdge) && edges.testFlag(Qt::Edge::RightEdge))
-            || (edges.testFlag(Qt::Edge::BottomEdge) && edges.testFlag(Qt::Edge::LeftEdge))) {
-            return Qt::CursorShape::SizeBDiagCursor;
+        if (wasUnknown) {
+            qDebug() << "QWindow::startSystemMove() is not supported on"
+                     << QGuiApplication::platformName() << ", moving windows manually.";
         }
-        if (edges.testFlag(Qt::Edge::TopEdge) || edges.testFlag(Qt::Edge::BottomEdge)) {
-            return Qt::CursorShape::SizeVerCursor;
+        return false;
+    }
+    const Qt::Edges edges = HitTestEngine::toEdges(region);
+    if (edges == Qt::Edges{}) {
+        return false;
+    }
+    const bool wasUnknown = (capabilities.systemResize == PlatformCapability::Unknown);
+    if (probePlatformCapability(capabilities.systemResize,
+                                [window, edges] { return window->startSystemResize(edges); })) {
+        return true;
+    }
+    if (wasUnknown) {
+        qDebug() << "QWindow::startSystemResize() is not supported on"
+                 << QGuiApplication::platformName() << ", resizing windows manually.";
+    }
+    return false;
+}
+
+void FramelessHelper::startGesture(QWindow *window, WindowState &state)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(state.gesture == GestureState::Pressed);
+    const bool isMove = (state.pressRegion == HitTestEngine::Region::Caption);
+    if (!startSystemMoveOrResize(window, state.pressRegion)) {
+        // Follow the mouse ourselves, from where the press happened, so the
+        // window doesn't lag behind by the drag distance.
+        state.manualGesture = true;
+        setManualUpdatePending(state, false);
+        state.pressGeometry = window->geometry();
+        state.cursorPosition = state.pressPosition;
+    }
+    // Otherwise the window manager owns the pointer from now on, we only
+    // learn about the end of the gesture from the next release or
+    // button-less move.
+    state.gesture = isMove ? GestureState::Dragging : GestureState::Resizing;
+    ++m_startedGestures;
+    Q_EMIT dragStarted(window, state.pressRegion);
+}
+
+void FramelessHelper::updateManualGesture(QWindow *window, WindowState &state)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(state.manualGesture);
+    setManualUpdatePending(state, false);
+    if ((state.gesture == GestureState::Resizing) && state.metrics.fixedSize) {
+        return;
+    }
+    const QPoint delta = (state.cursorPosition - state.pressPosition).toPoint();
+    QRect geometry = getManualGeometry(state.pressRegion,
+                                       state.pressGeometry,
+                                       delta,
+                                       window->minimumSize(),
+                                       window->maximumSize());
+    if (state.snapping && (state.gesture == GestureState::Dragging)) {
+        const QVector<WindowSnapper::Screen> &screens = getScreenTopology()->screens();
+        geometry = WindowSnapper::snapToEdges(screens, geometry, m_snapDistance);
+        state.snapTile = WindowSnapper::getTile(screens,
+                                                state.cursorPosition.toPoint(),
+                                                m_snapDistance,
+                                                &state.snapScreen);
+    }
+    if (geometry == window->geometry()) {
+        return;
+    }
+    if (state.gesture == GestureState::Dragging) {
+        window->setPosition(geometry.topLeft());
+    } else {
+        window->setGeometry(geometry);
+    }
+    ++m_manualGeometryUpdates;
+}
+
+void FramelessHelper::setManualUpdatePending(WindowState &state, const bool val)
+{
+    if (state.manualUpdatePending == val) {
+        return;
+    }
+    state.manualUpdatePending = val;
+    if (val) {
+        ++m_pendingManualUpdates;
+    } else {
+        Q_ASSERT(m_pendingManualUpdates > 0);
+        --m_pendingManualUpdates;
+    }
+}
+
+void FramelessHelper::finishManualGesture(QWindow *window, WindowState &state)
+{
+    Q_ASSERT(window);
+    if (state.manualUpdatePending) {
+        updateManualGesture(window, state);
+    }
+    if (state.snapTile != WindowSnapper::Tile::None) {
+        const QVector<WindowSnapper::Screen> &screens = getScreenTopology()->screens();
+        if (state.snapTile == WindowSnapper::Tile::Maximized) {
+            window->showMaximized();
+        } else if ((state.snapScreen >= 0) && (state.snapScreen < screens.size())) {
+            window->setGeometry(
+                WindowSnapper::getTileGeometry(screens.at(state.snapScreen).availableGeometry,
+                                               state.snapTile));
+            ++m_manualGeometryUpdates;
         }
-        if (edges.testFlag(Qt::Edge::LeftEdge) || edges.testFlag(Qt::Edge::RightEdge)) {
-            return Qt::CursorShape::SizeHorCursor;
+        state.snapTile = WindowSnapper::Tile::None;
+    }
+    finishGesture(window, state);
+}
+
+void FramelessHelper::abortGesture(WindowState &state)
+{
+    if (state.gesture == GestureState::Pressed) {
+        ++m_abortedGestures;
+        state.gesture = GestureState::Idle;
+    }
+}
+
+void FramelessHelper::finishGesture(QWindow *window, WindowState &state)
+{
+    Q_ASSERT(window);
+    abortGesture(state);
+    state.manualGesture = false;
+    if (state.gesture != GestureState::Idle) {
+        state.gesture = GestureState::Idle;
+        Q_EMIT dragFinished(window);
+    }
+}
+
+void FramelessHelper::toggleMaximized(QWindow *window, WindowState &state)
+{
+    Q_ASSERT(window);
+    if (window->windowStates().testFlag(Qt::WindowState::WindowFullScreen)) {
+        return;
+    }
+    if (window->windowStates().testFlag(Qt::WindowState::WindowMaximized)) {
+        window->showNormal();
+    } else {
+        window->showMaximized();
+    }
+    updateCursor(window, state, Qt::CursorShape::ArrowCursor);
+}
+
+void FramelessHelper::handleTouchEvent(QWindow *window, WindowState &state, QTouchEvent *event)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(event);
+    TouchGestureRecognizer &recognizer = state.touchGesture;
+    const auto finishTouchDrag = [this, window, &state]() {
+        if (state.touchDragging) {
+            state.touchDragging = false;
+            Q_EMIT dragFinished(window);
         }
-        return Qt::CursorShape::ArrowCursor;
     };
-    const auto isInSpecificObjects = [](const QPointF &mousePos,
-                                        const QObjectList &objects) -> bool {
-        if (objects.isEmpty()) {
-            return false;
-        }
-        for (auto &&obj : qAsConst(objects)) {
-            if (!obj) {
-                continue;
-            }
-            if (!obj->isWidgetType() && !obj->inherits("QQuickItem")) {
-                qWarning() << obj << "is not a QWidget or QQuickItem!";
-                continue;
-            }
-            if (!obj->property("visible").toBool()) {
-                qDebug() << "Skipping invisible object" << obj;
-                continue;
-            }
-            const auto mapOriginPointToWindow = [](const QObject *obj) -> QPointF {
-                Q_ASSERT(obj);
-                QPointF point = {obj->property("x").toReal(), obj->property("y").toReal()};
-                for (QObject *parent = obj->parent(); parent; parent = parent->parent()) {
-                    point += {parent->property("x").toReal(), parent->property("y").toReal()};
-                }
-                return point;
-            };
-            const QPointF originPoint = mapOriginPointToWindow(obj);
-            const qreal width = obj->property("width").toReal();
-            const qreal height = obj->property("height").toReal();
-            if (QRectF(originPoint.x(), originPoint.y(), width, height).contains(mousePos)) {
-                return true;
-            }
+    if (event->type() == QEvent::TouchBegin) {
+        recognizer.reset();
+        recognizer.setDragDistance(getDragDistance());
+        finishTouchDrag();
+        // The slots of dragFinished() may have destroyed the window.
+        if (!m_windowStates.find(window)) {
+            return;
         }
-        return false;
-    };
-    const auto isInTitlebarArea = [this, &isInSpecificObjects](const QPointF &globalPoint,
-                                                               const QPointF &point,
-                                                               const QWindow *window) -> bool {
-        Q_ASSERT(window);
-        return (point.y() <= m_titleBarHeight)
-               && !isInSpecificObjects(globalPoint, getIgnoreObjects(window));
-    };
-    const auto moveOrResize =
-        [this, &getWindowEdges, &isInTitlebarArea, &isInSpecificObjects](const QPointF &globalPoint,
-                                                                         const QPointF &point,
-                                                                         QWindow *window) {
-            Q_ASSERT(window);
-            //const QPointF deltaPoint = globalPoint - m_pOldMousePos;
-            const Qt::Edges edges = getWindowEdges(point, window->width(), window->height());
-            if (edges == Qt::Edges{}) {
-                if (isInTitlebarArea(globalPoint, point, window)) {
-                    if (!window->startSystemMove()) {
-                        // ### FIXME: TO BE IMPLEMENTED!
-                        qWarning() << "Current OS doesn't support QWindow::startSystemMove().";
-                    }
-                }
-            } else {
-                if (window->windowStates().testFlag(Qt::WindowState::WindowNoState)
-                    && !isInSpecificObjects(globalPoint, getIgnoreObjects(window))
-                    && getResizable(window)) {
-                    if (!window->startSystemResize(edges)) {
-                        // ### FIXME: TO BE IMPLEMENTED!
-                        qWarning() << "Current OS doesn't support QWindow::startSystemResize().";
-                    }
-                }
-            }
-        };
-    const auto getMousePos = [](const QMouseEvent *e, const bool global) -> QPointF {
-        Q_ASSERT(e);
+    } else if (event->type() == QEvent::TouchCancel) {
+        recognizer.reset();
+        finishTouchDrag();
+        return;
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const auto &touchPoints = event->points();
+#else
+    const auto &touchPoints = event->touchPoints();
+#endif
+    QVarLengthArray<TouchGestureRecognizer::Point, 10> points = {};
+    for (auto &&touchPoint : touchPoints) {
+        TouchGestureRecognizer::Point point = {};
+        point.id = touchPoint.id();
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        return global ? e->globalPosition() : e->scenePosition();
+        point.position = touchPoint.position();
 #else
-        return global ? e->screenPos() : e->windowPos();
+        point.position = touchPoint.pos();
 #endif
+        const QSizeF diameters = touchPoint.ellipseDiameters();
+        point.diameter = qMax(diameters.width(), diameters.height());
+        point.state = getPointState(touchPoint);
+        // Only the new points can become part of a gesture.
+        if (point.state == TouchGestureRecognizer::PointState::Pressed) {
+            point.region = hitTest(window, state, point.position);
+        }
+        points.append(point);
+    }
+    const TouchGestureRecognizer::Result result = recognizer.process(points.constData(),
+                                                                     points.size());
+    switch (result.action) {
+    case TouchGestureRecognizer::Action::MoveOrResize:
+        if (startSystemMoveOrResize(window, result.region)) {
+            ++m_startedGestures;
+            state.touchDragging = true;
+            Q_EMIT dragStarted(window, result.region);
+            if (!m_windowStates.find(window)) {
+                return;
+            }
+        } else {
+            ++m_abortedGestures;
+        }
+        break;
+    case TouchGestureRecognizer::Action::ToggleMaximized:
+        toggleMaximized(window, state);
+        break;
+    case TouchGestureRecognizer::Action::None:
+        break;
+    }
+    if (event->type() == QEvent::TouchEnd) {
+        recognizer.reset();
+        finishTouchDrag();
+    }
+}
+
+void FramelessHelper::removeWindowFrame(QWindow *window)
+{
+    Q_ASSERT(window);
+    window->setFlags(Qt::Window | Qt::FramelessWindowHint | Qt::WindowSystemMenuHint
+                     | Qt::WindowMinMaxButtonsHint | Qt::WindowTitleHint);
+    // The flags may have changed the geometry, start from fresh metrics but
+    // keep the settings of the window.
+    WindowState &state = getOrCreateWindowState(window);
+    resetMetrics(window, state);
+    state.active = isWindowActive(window);
+    // MouseTracking is always enabled for QWindow.
+    window->installEventFilter(this);
+}
+
+bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    const int type = event->type();
+    quint8 eventFlags = (type < m_eventTableSize) ? m_eventTable.flags[type] : Ignored;
+    // Every window asks for updates all the time, we only care about the
+    // frames a manual move or resize is waiting for.
+    if ((type == QEvent::UpdateRequest) && (m_pendingManualUpdates > 0)) {
+        eventFlags = Interactive;
+    }
+    if ((eventFlags == Ignored) || !object->isWindowType()) {
+        return false;
+    }
+    // QWindow will always be a top level window. It can't
+    // be anyone's child window.
+    const auto currentWindow = static_cast<QWindow *>(object);
+    WindowState *state = m_windowStates.find(currentWindow);
+    if (!state || (!state->active && (eventFlags != Lifecycle))) {
+        return false;
+    }
+    // The slots connected to our signals may destroy the window, which drops
+    // its state. As long as the window is there, its record doesn't move.
+    const auto isWindowGone = [this, currentWindow]() -> bool {
+        return !m_windowStates.find(currentWindow);
     };
+    // Whether the event is entirely ours, see setConsumeHandledEvents().
+    bool handled = false;
     switch (event->type()) {
     case QEvent::MouseButtonDblClick: {
         const auto mouseEvent = static_cast<QMouseEvent *>(event);
@@ -245,44 +1074,101 @@ bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
             if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
                 break;
             }
-            if (isInTitlebarArea(getMousePos(mouseEvent, true),
-                                 getMousePos(mouseEvent, false),
-                                 currentWindow)) {
-                if (currentWindow->windowStates().testFlag(Qt::WindowState::WindowFullScreen)) {
-                    break;
-                }
-                if (currentWindow->windowStates().testFlag(Qt::WindowState::WindowMaximized)) {
-                    currentWindow->showNormal();
-                } else {
-                    currentWindow->showMaximized();
-                }
-                currentWindow->setCursor(Qt::CursorShape::ArrowCursor);
+            if (hitTest(currentWindow, *state, getMousePos(mouseEvent, false))
+                == HitTestEngine::Region::Caption) {
+                toggleMaximized(currentWindow, *state);
+                handled = true;
             }
+            abortGesture(*state);
         }
     } break;
     case QEvent::MouseButtonPress: {
         const auto mouseEvent = static_cast<QMouseEvent *>(event);
         if (mouseEvent) {
-            if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
+            if ((mouseEvent->button() != Qt::MouseButton::LeftButton)
+                || isSynthesizedFromTouch(mouseEvent)) {
                 break;
             }
-            m_bIsMRBPressed = true;
-            m_pOldMousePos = getMousePos(mouseEvent, true);
-            moveOrResize(getMousePos(mouseEvent, true),
-                         getMousePos(mouseEvent, false),
-                         currentWindow);
+            // In case we missed the end of the previous gesture.
+            finishGesture(currentWindow, *state);
+            if (isWindowGone()) {
+                return false;
+            }
+            const HitTestEngine::Region region = hitTest(currentWindow,
+                                                         *state,
+                                                         getMousePos(mouseEvent, false));
+            if ((region == HitTestEngine::Region::Client)
+                || (region == HitTestEngine::Region::FixedBorder)) {
+                break;
+            }
+            if (region == HitTestEngine::Region::Caption) {
+                Q_EMIT captionPressed(currentWindow, getMousePos(mouseEvent, false));
+                if (isWindowGone()) {
+                    return false;
+                }
+            }
+            // Nothing happens yet, the click may just be meant for something
+            // inside the title bar.
+            state->gesture = GestureState::Pressed;
+            state->pressRegion = region;
+            state->pressPosition = getMousePos(mouseEvent, true);
+            state->pressTimestamp = mouseEvent->timestamp();
+            handled = true;
         }
     } break;
     case QEvent::MouseMove: {
         const auto mouseEvent = static_cast<QMouseEvent *>(event);
         if (mouseEvent) {
-            if (currentWindow->windowStates().testFlag(Qt::WindowState::WindowNoState)
-                && getResizable(currentWindow)) {
-                currentWindow->setCursor(
-                    getCursorShape(getWindowEdges(getMousePos(mouseEvent, false),
-                                                  currentWindow->width(),
-                                                  currentWindow->height())));
+            const bool leftButtonDown = mouseEvent->buttons().testFlag(Qt::LeftButton);
+            handled = (state->gesture != GestureState::Idle) && leftButtonDown;
+            if (state->manualGesture) {
+                if (!leftButtonDown) {
+                    finishManualGesture(currentWindow, *state);
+                    break;
+                }
+                // Only the latest position matters, one geometry change per
+                // frame is all the window manager can show anyway.
+                state->cursorPosition = getMousePos(mouseEvent, true);
+                if (state->manualUpdatePending) {
+                    ++m_coalescedManualMoves;
+                } else {
+                    setManualUpdatePending(*state, true);
+                    currentWindow->requestUpdate();
+                }
+                break;
+            }
+            if (state->gesture == GestureState::Pressed) {
+                if (!leftButtonDown) {
+                    // The release went somewhere else.
+                    abortGesture(*state);
+                } else {
+                    const QPointF delta = getMousePos(mouseEvent, true) - state->pressPosition;
+                    const quint64 elapsed = quint64(mouseEvent->timestamp())
+                                            - state->pressTimestamp;
+                    if ((delta.manhattanLength() >= getDragDistance())
+                        || (elapsed >= quint64(qMax(getDragTime(), 0)))) {
+                        startGesture(currentWindow, *state);
+                    }
+                }
+            } else if ((state->gesture != GestureState::Idle) && !leftButtonDown) {
+                finishGesture(currentWindow, *state);
+            }
+            if (isWindowGone()) {
+                return false;
             }
+            // Maximized windows have no edges and the edges of fixed size
+            // windows have no resize cursor, the hit test takes care of it.
+            const HitTestEngine::Region region = hitTest(currentWindow,
+                                                         *state,
+                                                         getMousePos(mouseEvent, false));
+            if (region != state->hoveredRegion) {
+                state->hoveredRegion = region;
+                Q_EMIT regionHovered(currentWindow, region);
+                if (isWindowGone()) {
+                    return false;
+                }
+            }
+            updateCursor(currentWindow, *state, HitTestEngine::toCursorShape(region));
         }
     } break;
     case QEvent::MouseButtonRelease: {
@@ -291,23 +1177,76 @@ bool FramelessHelper::eventFilter(QObject *object, QEvent *event)
             if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
                 break;
             }
-            m_bIsMRBPressed = false;
-            m_pOldMousePos = {};
+            handled = (state->gesture != GestureState::Idle);
+            if (state->manualGesture) {
+                state->cursorPosition = getMousePos(mouseEvent, true);
+                setManualUpdatePending(*state, true);
+                finishManualGesture(currentWindow, *state);
+                break;
+            }
+            // Released before reaching the thresholds, it was a click.
+            finishGesture(currentWindow, *state);
         }
     } break;
-    case QEvent::TouchBegin:
-    case QEvent::TouchUpdate: {
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-        const auto point = static_cast<QTouchEvent *>(event)->points().first();
-        moveOrResize(point.globalPosition(), point.position(), currentWindow);
-#else
-        const auto point = static_cast<QTouchEvent *>(event)->touchPoints().first();
-        moveOrResize(point.screenPos(), point.pos(), currentWindow);
+    case QEvent::KeyPress: {
+        if (static_cast<QKeyEvent *>(event)->key() == Qt::Key_Escape) {
+            abortGesture(*state);
+        }
+    } break;
+    case QEvent::Leave:
+        if (state->hoveredRegion != HitTestEngine::Region::Client) {
+            state->hoveredRegion = HitTestEngine::Region::Client;
+            Q_EMIT regionHovered(currentWindow, HitTestEngine::Region::Client);
+        }
+        break;
+    case QEvent::Hide:
+        abortGesture(*state);
+        if (state->manualGesture) {
+            finishManualGesture(currentWindow, *state);
+            if (isWindowGone()) {
+                return false;
+            }
+        }
+        state->active = false;
+        break;
+    case QEvent::Show:
+        state->active = !currentWindow->windowStates().testFlag(Qt::WindowMinimized);
+        break;
+    case QEvent::UpdateRequest:
+        if (state->manualGesture && state->manualUpdatePending) {
+            updateManualGesture(currentWindow, *state);
+        }
+        break;
+    case QEvent::Resize: {
+        state->size = static_cast<QResizeEvent *>(event)->size();
+        updateMetrics(*state);
+    } break;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
+    case QEvent::DevicePixelRatioChange:
+        state->devicePixelRatio = currentWindow->devicePixelRatio();
+        updateMetrics(*state);
+        break;
 #endif
+    case QEvent::WindowStateChange: {
+        state->metrics.maximized = !currentWindow->windowStates().testFlag(
+            Qt::WindowState::WindowNoState);
+        state->hitTestCache.clear();
+        state->active = isWindowActive(currentWindow);
+        Q_EMIT windowStateChanged(currentWindow, getWindowState(currentWindow->windowStates()));
     } break;
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+    case QEvent::TouchCancel:
+        handleTouchEvent(currentWindow, *state, static_cast<QTouchEvent *>(event));
+        break;
     default:
         break;
     }
-    return false;
+    // After dragFinished(), regionHovered() or windowStateChanged().
+    if (isWindowGone()) {
+        return false;
+    }
+    return handled && state->consumeHandledEvents;
 }
 #endif
@@ -27,19 +27,39 @@
 #include "framelesshelper_global.h"
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-#include <QHash>
+#include "framelesswindowstore.h"
+#include "hittestengine.h"
+#include "titlebarareas.h"
+#include "touchgesturerecognizer.h"
+#include "windowsnapper.h"
+#include <QCursor>
 #include <QObject>
+#include <QPointF>
+#include <QPointer>
+#include <QRect>
+#include <QSize>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QTouchEvent)
 QT_FORWARD_DECLARE_CLASS(QWindow)
 QT_END_NAMESPACE
 
+class ScreenTopology;
+
 class FRAMELESSHELPER_EXPORT FramelessHelper : public QObject
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(FramelessHelper)
 
 public:
+    // A press on the title bar or on one of the edges first waits in
+    // "Pressed": the system move or resize only starts once the mouse has
+    // travelled far enough or the button has been held long enough, so a
+    // plain click still reaches the application.
+    enum class GestureState { Idle, Pressed, Dragging, Resizing };
+    Q_ENUM(GestureState)
+
     explicit FramelessHelper(QObject *parent = nullptr);
     ~FramelessHelper() override = default;
 
@@ -54,21 +74,213 @@ public:
     int getTitleBarHeight() const;
     void setTitleBarHeight(const int val);
 
+    // The same metrics for a single window, in logical pixels. Negative
+    // values (the default) follow the helper-wide ones above.
+    int getBorderWidth(const QWindow *window) const;
+    void setBorderWidth(const QWindow *window, const int val);
+
+    int getBorderHeight(const QWindow *window) const;
+    void setBorderHeight(const QWindow *window, const int val);
+
+    int getTitleBarHeight(const QWindow *window) const;
+    void setTitleBarHeight(const QWindow *window, const int val);
+
     void addIgnoreObject(const QWindow *window, QObject *val);
+    void addIgnoreObjects(const QWindow *window, const QObjectList &val);
+    void removeIgnoreObject(const QWindow *window, const QObject *val);
+    void clearIgnoreObjects(const QWindow *window);
     QObjectList getIgnoreObjects(const QWindow *window) const;
 
+    // Arbitrary ignore shapes, in the window's coordinate system, in logical
+    // pixels.
+    void addIgnoreRegion(const QWindow *window, const QRegion &region);
+    void addIgnorePath(const QWindow *window, const QPainterPath &path);
+
+    // Explicit drag areas, only used in allow-list mode: then nothing but
+    // these areas drags the window.
+    void addDragObject(const QWindow *window, QObject *val);
+    QObjectList getDragObjects(const QWindow *window) const;
+    void addDragRect(const QWindow *window, const QRectF &rect);
+
+    bool isDragAllowListEnabled(const QWindow *window) const;
+    void setDragAllowListEnabled(const QWindow *window, const bool val);
+
+    // Z-order aware hit testing of the ignore and drag objects: only the
+    // topmost widget or item under the mouse (and its ancestors) counts.
+    bool isZOrderHitTestEnabled(const QWindow *window) const;
+    void setZOrderHitTestEnabled(const QWindow *window, const bool val);
+
     bool getResizable(const QWindow *window) const;
     void setResizable(const QWindow *window, const bool val);
 
+    // Keep the mouse events we have fully handled away from the window's
+    // widgets or items: every event of a press on the title bar or on an
+    // edge (press, moves and release), and double clicks that toggled the
+    // maximized state. Presses on the ignored areas are never consumed.
+    // Disabled by default.
+    bool getConsumeHandledEvents(const QWindow *window) const;
+    void setConsumeHandledEvents(const QWindow *window, const bool val);
+
+    // Draggable and non-draggable title bar zones, in logical pixels.
+    // Applied after the drag areas and before the ignore objects.
+    TitleBarRegionMap getTitleBarRegionMap(const QWindow *window) const;
+    void setTitleBarRegionMap(const QWindow *window, const TitleBarRegionMap &map);
+
+    // Runs before the resize edges, the drag areas, the zone map and the
+    // ignored areas, see HitTestEngine::Callback.
+    HitTestEngine::Callback getHitTestCallback(const QWindow *window) const;
+    void setHitTestCallback(const QWindow *window, const HitTestEngine::Callback &callback);
+
+    // The drag thresholds, in logical pixels and in milliseconds. Negative
+    // values (the default) follow the drag and drop settings of the platform.
+    int getDragDistance() const;
+    void setDragDistance(const int val);
+
+    int getDragTime() const;
+    void setDragTime(const int val);
+
+    GestureState getGestureState(const QWindow *window) const;
+    // Drops a pending press, the system move or resize won't start anymore.
+    // A gesture which has already been handed over to the system can't be
+    // taken back.
+    void cancelGesture(const QWindow *window);
+
+    // How many presses turned into a system move or resize, and how many
+    // ended (released, cancelled or refused by the platform) before that.
+    quint64 getStartedGestures() const;
+    quint64 getAbortedGestures() const;
+
+    // When the platform can't move or resize a window itself, we do it from
+    // the mouse events, at most once per frame. How many geometry changes
+    // (each one relayouts the window) have been applied that way, and how
+    // many mouse moves have been folded into a pending one.
+    quint64 getManualGeometryUpdates() const;
+    quint64 getCoalescedManualMoves() const;
+
+    // Snapping for the manual moves above, which don't get the one of the
+    // window manager: the window edges stick to the screen edges within the
+    // snap distance (in logical pixels), and dropping the window with the
+    // cursor on a screen edge maximizes it or tiles it to a half or a
+    // quarter of the screen. Disabled by default.
+    bool isSnappingEnabled(const QWindow *window) const;
+    void setSnappingEnabled(const QWindow *window, const bool val);
+
+    int getSnapDistance() const;
+    void setSnapDistance(const int val);
+
+    // "point" is in the window's coordinate system, in logical pixels.
+    HitTestEngine::Region hitTest(const QWindow *window, const QPointF &point) const;
+    QVector<HitTestEngine::Region> hitTest(const QWindow *window,
+                                           const QVector<QPointF> &points) const;
+
+    // How many times the cursor of a window has been changed by us, and how
+    // many mouse moves didn't need to touch it at all.
+    quint64 getAppliedCursorUpdates() const;
+    quint64 getSuppressedCursorUpdates() const;
+
+    // Statistics of the per-window memo in front of hitTest().
+    quint64 getHitTestCacheHits() const;
+    quint64 getHitTestCacheMisses() const;
+
+Q_SIGNALS:
+    // All computed by the event filter we install anyway, so applications
+    // don't need another one on the same window, and every event is only
+    // classified once.
+    void regionHovered(QWindow *window, HitTestEngine::Region region);
+    // A press on the draggable part of the title bar, "point" is in the
+    // window's coordinate system.
+    void captionPressed(QWindow *window, const QPointF &point);
+    // The most relevant state: full screen, maximized, minimized or normal.
+    void windowStateChanged(QWindow *window, Qt::WindowState state);
+    void activeChanged(QWindow *window, bool active);
+    // "region" is Caption for a move, one of the edges for a resize.
+    void dragStarted(QWindow *window, HitTestEngine::Region region);
+    void dragFinished(QWindow *window);
+
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
 
 private:
+    // Everything we know about one window, looked up once per event.
+    struct WindowState
+    {
+        // In device pixels, so the edges are whole pixels on every screen.
+        // Kept up to date by the resize and state change events and by the
+        // screen changes, so the hit test never has to query the window.
+        HitTestEngine::Metrics metrics = {};
+        // What the metrics are computed from: the size of the window in
+        // logical pixels, its own border and title bar settings (see
+        // setBorderWidth()) and its device pixel ratio.
+        QSize size = {};
+        int borderWidth = -1;
+        int borderHeight = -1;
+        int titleBarHeight = -1;
+        qreal devicePixelRatio = 1.0;
+        QPointer<TitleBarAreas> titleBarAreas = nullptr;
+        HitTestCache hitTestCache = {};
+        // Visible and not minimized, nothing to do otherwise.
+        bool active = false;
+        // The cursor we have set on the window, Qt::ArrowCursor means we
+        // don't override it, so the application is free to use its own one.
+        Qt::CursorShape cursorShape = Qt::ArrowCursor;
+        // The one of the application, put back once we stop overriding it.
+        QCursor applicationCursor = {};
+        HitTestEngine::Region hoveredRegion = HitTestEngine::Region::Client;
+        bool consumeHandledEvents = false;
+        GestureState gesture = GestureState::Idle;
+        HitTestEngine::Region pressRegion = HitTestEngine::Region::Client;
+        // In global coordinates.
+        QPointF pressPosition = {};
+        quint64 pressTimestamp = 0;
+        TouchGestureRecognizer touchGesture = {};
+        bool touchDragging = false;
+        // The software move or resize.
+        bool manualGesture = false;
+        bool manualUpdatePending = false;
+        QRect pressGeometry = {};
+        // In global coordinates.
+        QPointF cursorPosition = {};
+        bool snapping = false;
+        WindowSnapper::Tile snapTile = WindowSnapper::Tile::None;
+        int snapScreen = -1;
+    };
+
+    HitTestEngine::Metrics getHitTestMetrics(const QWindow *window) const;
+    void resetMetrics(const QWindow *window, WindowState &state) const;
+    void updateMetrics(WindowState &state) const;
+    WindowState &getOrCreateWindowState(const QWindow *window);
+    const TitleBarAreas *getTitleBarAreas(const QWindow *window) const;
+    TitleBarAreas *getOrCreateTitleBarAreas(const QWindow *window);
+    HitTestEngine::Region hitTest(const QWindow *window,
+                                  WindowState &state,
+                                  const QPointF &point) const;
+    void updateCursor(QWindow *window, WindowState &state, const Qt::CursorShape shape);
+    static bool startSystemMoveOrResize(QWindow *window, const HitTestEngine::Region region);
+    void startGesture(QWindow *window, WindowState &state);
+    void abortGesture(WindowState &state);
+    void finishGesture(QWindow *window, WindowState &state);
+    void updateManualGesture(QWindow *window, WindowState &state);
+    void setManualUpdatePending(WindowState &state, const bool val);
+    void finishManualGesture(QWindow *window, WindowState &state);
+    ScreenTopology *getScreenTopology();
+    void toggleMaximized(QWindow *window, WindowState &state);
+    void handleTouchEvent(QWindow *window, WindowState &state, QTouchEvent *event);
+
     // ### FIXME: The default border width and height on Windows is 8 pixels if
     // the scale factor is 1.0. Don't know how to acquire these values on UNIX
     // platforms through native API.
     int m_borderWidth = 8, m_borderHeight = 8, m_titleBarHeight = 30;
-    QHash<const QWindow *, QObjectList> m_ignoreObjects = {};
-    QHash<const QWindow *, bool> m_fixedSize = {};
+    int m_dragDistance = -1, m_dragTime = -1;
+    quint64 m_startedGestures = 0, m_abortedGestures = 0;
+    quint64 m_manualGeometryUpdates = 0, m_coalescedManualMoves = 0;
+    // How many windows wait for an UpdateRequest to apply a manual move or
+    // resize, the event filter skips the update requests otherwise.
+    int m_pendingManualUpdates = 0;
+    int m_snapDistance = 16;
+    // Created the first time a window snaps.
+    ScreenTopology *m_screenTopology = nullptr;
+    // The hit test memo lives in here, hence mutable.
+    mutable FramelessWindowStore<const QWindow *, WindowState> m_windowStates = {};
+    quint64 m_appliedCursorUpdates = 0, m_suppressedCursorUpdates = 0;
 };
 #endif
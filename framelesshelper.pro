@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 CONFIG -= ordered
-SUBDIRS += lib examples
+SUBDIRS += lib examples tests
 lib.file = lib.pro
 examples.depends += lib
+tests.depends += lib
@@ -0,0 +1,591 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessobjectindex.h"
+
+#include <QDebug>
+#include <QEvent>
+#include <QtMath>
+#ifdef QT_WIDGETS_LIB
+#include <QWidget>
+#endif
+#ifdef QT_QUICK_LIB
+#include <QQuickItem>
+#include <QQuickWindow>
+#endif
+
+namespace {
+
+// The edge length of a grid cell, in logical pixels. Title bar controls are
+// rarely smaller than this, so most cells only reference one or two objects.
+const qreal m_defaultCellSize = 32.0;
+
+// Upper bound of the cell count, the cells get coarser for huge windows.
+const int m_maximumCellCount = 4096;
+
+bool isSupportedObject(const QObject *object)
+{
+    Q_ASSERT(object);
+    return object->isWidgetType() || object->inherits("QQuickItem");
+}
+
+} // namespace
+
+FramelessObjectIndex::FramelessObjectIndex(QObject *parent) : QObject(parent) {}
+
+FramelessObjectIndex::ObjectType FramelessObjectIndex::resolveObjectType(const QObject *object)
+{
+    Q_ASSERT(object);
+#ifdef QT_WIDGETS_LIB
+    if (object->isWidgetType()) {
+        return ObjectType::Widget;
+    }
+#endif
+#ifdef QT_QUICK_LIB
+    if (qobject_cast<const QQuickItem *>(object)) {
+        return ObjectType::QuickItem;
+    }
+#endif
+    return ObjectType::Reflection;
+}
+
+// The top level object (the window, the top level widget or the root item) is
+// the origin of the coordinate system, so neither its position nor its
+// geometry changes have any influence on the objects inside of it.
+bool FramelessObjectIndex::isTopLevelObject(const QObject *object, const ObjectType type)
+{
+    Q_ASSERT(object);
+    switch (type) {
+#ifdef QT_WIDGETS_LIB
+    case ObjectType::Widget:
+        return static_cast<const QWidget *>(object)->isWindow();
+#endif
+#ifdef QT_QUICK_LIB
+    case ObjectType::QuickItem:
+        return !static_cast<const QQuickItem *>(object)->parentItem();
+#endif
+    default:
+        break;
+    }
+    return !object->parent() || object->isWindowType();
+}
+
+QObject *FramelessObjectIndex::parentObject(const QObject *object, const ObjectType type)
+{
+    Q_ASSERT(object);
+    switch (type) {
+#ifdef QT_WIDGETS_LIB
+    case ObjectType::Widget:
+        return static_cast<const QWidget *>(object)->parentWidget();
+#endif
+#ifdef QT_QUICK_LIB
+    case ObjectType::QuickItem:
+        return static_cast<const QQuickItem *>(object)->parentItem();
+#endif
+    default:
+        break;
+    }
+    return object->parent();
+}
+
+// Returns an empty rectangle for invisible objects.
+QRectF FramelessObjectIndex::mapObjectRectToWindow(const QObject *object, const ObjectType type)
+{
+    Q_ASSERT(object);
+    switch (type) {
+#ifdef QT_WIDGETS_LIB
+    case ObjectType::Widget: {
+        const auto widget = static_cast<const QWidget *>(object);
+        if (!widget->isVisible()) {
+            return {};
+        }
+        return {QPointF(widget->mapTo(widget->window(), QPoint{0, 0})), QSizeF(widget->size())};
+    }
+#endif
+#ifdef QT_QUICK_LIB
+    case ObjectType::QuickItem: {
+        const auto item = static_cast<const QQuickItem *>(object);
+        if (!item->isVisible()) {
+            return {};
+        }
+        // Unlike summing up the positions, this takes the transformations
+        // (scale, rotation and etc) of the item and its ancestors into account.
+        return item->mapRectToScene({0.0, 0.0, item->width(), item->height()});
+    }
+#endif
+    default:
+        break;
+    }
+    if (!object->property("visible").toBool()) {
+        return {};
+    }
+    QPointF point = {};
+    for (const QObject *obj = object; obj && !isTopLevelObject(obj, type);
+         obj = parentObject(obj, type)) {
+        point += {obj->property("x").toReal(), obj->property("y").toReal()};
+    }
+    return {point,
+            QSizeF{object->property("width").toReal(), object->property("height").toReal()}};
+}
+
+// Only called for points inside the bounding rectangle of the object.
+bool FramelessObjectIndex::containsPrecisely(const QObject *object,
+                                             const ObjectType type,
+                                             const QPointF &point)
+{
+    Q_ASSERT(object);
+    switch (type) {
+#ifdef QT_WIDGETS_LIB
+    case ObjectType::Widget: {
+        const auto widget = static_cast<const QWidget *>(object);
+        const QRegion mask = widget->mask();
+        if (mask.isEmpty()) {
+            return true;
+        }
+        return mask.contains(widget->mapFrom(widget->window(), point.toPoint()));
+    }
+#endif
+#ifdef QT_QUICK_LIB
+    case ObjectType::QuickItem: {
+        const auto item = static_cast<const QQuickItem *>(object);
+        return item->contains(item->mapFromScene(point));
+    }
+#endif
+    default:
+        break;
+    }
+    return true;
+}
+
+void FramelessObjectIndex::addObject(QObject *object)
+{
+    if (!object) {
+        return;
+    }
+    if (!isSupportedObject(object)) {
+        qWarning() << object << "is not a QWidget or QQuickItem!";
+        return;
+    }
+    if (m_entryIndices.contains(object)) {
+        return;
+    }
+    int index = -1;
+    if (m_freeEntries.isEmpty()) {
+        index = static_cast<int>(m_entries.size());
+        m_entries.append({});
+    } else {
+        index = m_freeEntries.takeLast();
+    }
+    m_entries[index] = {object, {}, resolveObjectType(object), true, {}};
+    m_entryIndices.insert(object, index);
+    watch(index);
+    m_dirty = true;
+    ++m_generation;
+}
+
+void FramelessObjectIndex::addObjects(const QObjectList &objects)
+{
+    for (auto &&object : qAsConst(objects)) {
+        addObject(object);
+    }
+}
+
+void FramelessObjectIndex::removeObject(const QObject *object)
+{
+    if (object) {
+        release(object);
+    }
+}
+
+void FramelessObjectIndex::setObjects(const QObjectList &objects)
+{
+    clear();
+    addObjects(objects);
+}
+
+void FramelessObjectIndex::clear()
+{
+    for (auto it = m_dependents.cbegin(); it != m_dependents.cend(); ++it) {
+        unwatch(it.key());
+    }
+    m_dependents.clear();
+    m_entries.clear();
+    m_freeEntries.clear();
+    m_entryIndices.clear();
+    m_dirty = true;
+    ++m_generation;
+}
+
+QObjectList FramelessObjectIndex::objects() const
+{
+    QObjectList ret{};
+    for (auto &&entry : qAsConst(m_entries)) {
+        if (entry.object) {
+            ret.append(entry.object);
+        }
+    }
+    return ret;
+}
+
+bool FramelessObjectIndex::isEmpty() const
+{
+    return m_entryIndices.isEmpty();
+}
+
+quint64 FramelessObjectIndex::generation() const
+{
+    return m_generation;
+}
+
+bool FramelessObjectIndex::contains(const QPointF &point)
+{
+    if (isEmpty()) {
+        return false;
+    }
+    if (m_dirty) {
+        update();
+    }
+    if (m_cellStart.isEmpty() || !m_bounds.contains(point)) {
+        return false;
+    }
+    const int column = qMin(static_cast<int>((point.x() - m_bounds.left()) / m_cellSize),
+                            m_columns - 1);
+    const int row = qMin(static_cast<int>((point.y() - m_bounds.top()) / m_cellSize), m_rows - 1);
+    const int cell = (row * m_columns) + column;
+    for (int i = m_cellStart.at(cell); i != m_cellStart.at(cell + 1); ++i) {
+        const Entry &entry = m_entries.at(m_cellEntries.at(i));
+        if (entry.object && entry.rect.contains(point)
+            && containsPrecisely(entry.object, entry.type, point)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FramelessObjectIndex::containsTopmost(const QPointF &point)
+{
+    if (isEmpty()) {
+        return false;
+    }
+    // Resolved again every time: whatever covers the registered objects
+    // doesn't have to be registered itself, so the generation can't tell
+    // when the topmost object has changed.
+    bool result = false;
+    if (!resolveTopmost(point, &result)) {
+        return contains(point);
+    }
+    return result;
+}
+
+bool FramelessObjectIndex::resolveTopmost(const QPointF &point, bool *result) const
+{
+    Q_ASSERT(result);
+    const QObject *object = nullptr;
+    ObjectType type = ObjectType::Reflection;
+    for (auto &&entry : qAsConst(m_entries)) {
+        if (entry.object) {
+            object = entry.object;
+            type = entry.type;
+            break;
+        }
+    }
+    if (!object) {
+        return false;
+    }
+    // Only pointer comparisons, the objects of the chain don't have to be
+    // registered.
+    switch (type) {
+#ifdef QT_WIDGETS_LIB
+    case ObjectType::Widget: {
+        const QWidget *root = static_cast<const QWidget *>(object)->window();
+        for (const QWidget *widget = root->childAt(point.toPoint()); widget;
+             widget = widget->parentWidget()) {
+            if (m_entryIndices.contains(widget)) {
+                *result = true;
+                return true;
+            }
+        }
+        *result = false;
+        return true;
+    }
+#endif
+#ifdef QT_QUICK_LIB
+    case ObjectType::QuickItem: {
+        const QQuickWindow *window = static_cast<const QQuickItem *>(object)->window();
+        if (!window) {
+            return false;
+        }
+        *result = false;
+        for (QQuickItem *item = window->contentItem(); item;) {
+            if (m_entryIndices.contains(item)) {
+                *result = true;
+                return true;
+            }
+            const QPointF local = item->mapFromScene(point);
+            item = item->childAt(local.x(), local.y());
+        }
+        return true;
+    }
+#endif
+    default:
+        break;
+    }
+    return false;
+}
+
+bool FramelessObjectIndex::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    switch (event->type()) {
+    case QEvent::Move:
+    case QEvent::Resize:
+    case QEvent::Show:
+    case QEvent::Hide:
+        markDirty(object, false);
+        break;
+    case QEvent::ParentChange:
+        markDirty(object, true);
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(object, event);
+}
+
+void FramelessObjectIndex::handleGeometryChange()
+{
+    markDirty(sender(), false);
+}
+
+void FramelessObjectIndex::handleParentChange()
+{
+    markDirty(sender(), true);
+}
+
+void FramelessObjectIndex::watch(const int index)
+{
+    Entry &entry = m_entries[index];
+    for (QObject *obj = entry.object; obj && !isTopLevelObject(obj, entry.type);
+         obj = parentObject(obj, entry.type)) {
+        auto dependents = m_dependents.find(obj);
+        const bool watched = (dependents != m_dependents.end());
+        if (!watched) {
+            dependents = m_dependents.insert(obj, {});
+        }
+        // Never watched by this entry yet, see releaseWatches().
+        dependents->append({index, static_cast<int>(entry.watched.size())});
+        entry.watched.append({obj, static_cast<int>(dependents->size() - 1)});
+        if (watched) {
+            continue;
+        }
+        connect(obj, &QObject::destroyed, this, [this](QObject *o) {
+            const auto it = m_dependents.find(o);
+            if (it != m_dependents.end()) {
+                for (auto &&dependent : qAsConst(it.value())) {
+                    removeWatch(dependent.entry, dependent.watch);
+                }
+                m_dependents.erase(it);
+            }
+            // The entry of a registered object goes away with it, so the
+            // index doesn't grow with every object that has ever been added.
+            release(o);
+            ++m_generation;
+        });
+        if (obj->isWidgetType()) {
+            obj->installEventFilter(this);
+        } else if (obj->inherits("QQuickItem")) {
+            // Quick items don't receive any events when their geometry
+            // changes, so listen to their notify signals instead. Connect
+            // by name, the library doesn't necessarily link to QtQuick.
+            connect(obj, SIGNAL(xChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(yChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(widthChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(heightChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(visibleChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(scaleChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(rotationChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(containmentMaskChanged()), this, SLOT(handleGeometryChange()));
+            connect(obj, SIGNAL(parentChanged(QQuickItem*)), this, SLOT(handleParentChange()));
+        }
+    }
+}
+
+void FramelessObjectIndex::unwatch(const QObject *object)
+{
+    Q_ASSERT(object);
+    const auto obj = const_cast<QObject *>(object);
+    obj->removeEventFilter(this);
+    disconnect(obj, nullptr, this, nullptr);
+}
+
+void FramelessObjectIndex::release(const QObject *object)
+{
+    const auto it = m_entryIndices.find(object);
+    if (it == m_entryIndices.end()) {
+        return;
+    }
+    const int index = it.value();
+    m_entryIndices.erase(it);
+    releaseWatches(index);
+    m_entries[index] = {};
+    m_freeEntries.append(index);
+    m_dirty = true;
+    ++m_generation;
+}
+
+void FramelessObjectIndex::releaseWatches(const int index)
+{
+    Entry &entry = m_entries[index];
+    for (auto &&watch : qAsConst(entry.watched)) {
+        const auto dependents = m_dependents.find(watch.object);
+        Q_ASSERT(dependents != m_dependents.end());
+        removeDependent(*dependents, watch.position);
+        if (dependents->isEmpty()) {
+            m_dependents.erase(dependents);
+            unwatch(watch.object);
+        }
+    }
+    entry.watched.clear();
+}
+
+// Both lists are unordered: the last item takes the place of the removed
+// one, and the back-index of the item it is paired with follows it.
+void FramelessObjectIndex::removeDependent(QVector<Dependent> &dependents, const int position)
+{
+    const Dependent last = dependents.last();
+    if (position != (dependents.size() - 1)) {
+        dependents[position] = last;
+        m_entries[last.entry].watched[last.watch].position = position;
+    }
+    dependents.removeLast();
+}
+
+void FramelessObjectIndex::removeWatch(const int index, const int position)
+{
+    QVector<Watch> &watched = m_entries[index].watched;
+    const Watch last = watched.last();
+    if (position != (watched.size() - 1)) {
+        watched[position] = last;
+        m_dependents[last.object][last.position].watch = position;
+    }
+    watched.removeLast();
+}
+
+void FramelessObjectIndex::markDirty(QObject *object, const bool reparented)
+{
+    Q_ASSERT(object);
+    const auto it = m_dependents.constFind(object);
+    if (it == m_dependents.constEnd()) {
+        return;
+    }
+    // Take a copy, re-watching an entry modifies the hash.
+    const QVector<Dependent> dependents = it.value();
+    for (auto &&dependent : qAsConst(dependents)) {
+        const int index = dependent.entry;
+        m_entries[index].dirty = true;
+        if (reparented) {
+            // The old ancestors don't matter anymore, only the new ones.
+            releaseWatches(index);
+            watch(index);
+        }
+    }
+    m_dirty = true;
+    ++m_generation;
+}
+
+void FramelessObjectIndex::update()
+{
+    m_dirty = false;
+    for (auto &&entry : m_entries) {
+        if (!entry.dirty) {
+            continue;
+        }
+        entry.dirty = false;
+        const QObject *object = entry.object;
+        entry.rect = object ? mapObjectRectToWindow(object, entry.type) : QRectF{};
+    }
+    rebuildGrid();
+}
+
+void FramelessObjectIndex::rebuildGrid()
+{
+    m_bounds = {};
+    m_columns = 0;
+    m_rows = 0;
+    m_cellStart.clear();
+    m_cellEntries.clear();
+    for (auto &&entry : qAsConst(m_entries)) {
+        if (entry.object && !entry.rect.isEmpty()) {
+            m_bounds = m_bounds.isEmpty() ? entry.rect : m_bounds.united(entry.rect);
+        }
+    }
+    if (m_bounds.isEmpty()) {
+        return;
+    }
+    m_cellSize = m_defaultCellSize;
+    do {
+        m_columns = qMax(qCeil(m_bounds.width() / m_cellSize), 1);
+        m_rows = qMax(qCeil(m_bounds.height() / m_cellSize), 1);
+        if ((m_columns * m_rows) <= m_maximumCellCount) {
+            break;
+        }
+        m_cellSize *= 2.0;
+    } while (true);
+    const auto forEachCell = [this](const QRectF &rect, const auto &callback) {
+        const int left = static_cast<int>((rect.left() - m_bounds.left()) / m_cellSize);
+        const int top = static_cast<int>((rect.top() - m_bounds.top()) / m_cellSize);
+        const int right = qMin(static_cast<int>((rect.right() - m_bounds.left()) / m_cellSize),
+                               m_columns - 1);
+        const int bottom = qMin(static_cast<int>((rect.bottom() - m_bounds.top()) / m_cellSize),
+                                m_rows - 1);
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                callback((row * m_columns) + column);
+            }
+        }
+    };
+    const auto isIndexed = [](const Entry &entry) -> bool {
+        return entry.object && !entry.rect.isEmpty();
+    };
+    // Counting sort the entries into the cells they overlap.
+    m_cellStart.fill(0, (m_columns * m_rows) + 1);
+    for (auto &&entry : qAsConst(m_entries)) {
+        if (isIndexed(entry)) {
+            forEachCell(entry.rect, [this](const int cell) { ++m_cellStart[cell + 1]; });
+        }
+    }
+    for (int i = 1; i != m_cellStart.size(); ++i) {
+        m_cellStart[i] += m_cellStart.at(i - 1);
+    }
+    m_cellEntries.resize(m_cellStart.last());
+    QVector<int> cursor = m_cellStart;
+    for (int i = 0; i != m_entries.size(); ++i) {
+        if (isIndexed(m_entries.at(i))) {
+            forEachCell(m_entries.at(i).rect, [this, &cursor, i](const int cell) {
+                m_cellEntries[cursor[cell]++] = i;
+            });
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QRectF>
+#include <QVector>
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 13, 0))
+#define Q_DISABLE_MOVE(Class) \
+    Class(Class &&) = delete; \
+    Class &operator=(Class &&) = delete;
+
+#define Q_DISABLE_COPY_MOVE(Class) \
+    Q_DISABLE_COPY(Class) \
+    Q_DISABLE_MOVE(Class)
+#endif
+
+// Spatial index over the title bar objects of one window. The window-space
+// rectangles of the registered objects are bucketed into a uniform grid, so a
+// hit test only looks at the handful of objects sharing a cell with the point
+// instead of walking the whole list on every mouse event.
+//
+// The rectangles are cached: they are only re-read after the object or one of
+// its ancestors has been moved, resized, shown, hidden or re-parented, so the
+// hit test itself never touches the meta-object system. When the library is
+// built against QtWidgets or QtQuick, the rectangles are read through the
+// typed QWidget/QQuickItem API, otherwise through QObject::property(). Only
+// the widgets and items also get a point inside their rectangle checked
+// against their shape: QWidget::mask() and QQuickItem::contains(), which
+// honours the containmentMask of the item. The objects read through
+// QObject::property() are plain rectangles.
+class FRAMELESSHELPER_EXPORT FramelessObjectIndex : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FramelessObjectIndex)
+    // Benchmarks the typed geometry reads against the reflection ones.
+    friend class tst_FramelessObjectIndex;
+
+public:
+    explicit FramelessObjectIndex(QObject *parent = nullptr);
+    ~FramelessObjectIndex() override = default;
+
+    // Registering and removing an object are amortized O(1), no matter how
+    // many objects are already there (or share its ancestors).
+    void addObject(QObject *object);
+    void addObjects(const QObjectList &objects);
+    void removeObject(const QObject *object);
+    void setObjects(const QObjectList &objects);
+    void clear();
+    QObjectList objects() const;
+    bool isEmpty() const;
+    // Bumped whenever the result of contains() may have changed.
+    quint64 generation() const;
+
+    // "point" is in the window's coordinate system, in logical pixels.
+    bool contains(const QPointF &point);
+    // Z-order aware version of contains(): resolves the topmost widget or
+    // item under the point (QWidget::childAt() or a QQuickItem::childAt()
+    // descent) and checks whether it or one of its ancestors is registered.
+    // Objects covered by something else don't count anymore. Nothing is
+    // cached, the covering objects aren't registered and may change at any
+    // time. Falls back to contains() when the objects can't be accessed
+    // through the QWidget/QQuickItem API.
+    bool containsTopmost(const QPointF &point);
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+
+private Q_SLOTS:
+    void handleGeometryChange();
+    void handleParentChange();
+
+private:
+    // Resolved once when the object is registered.
+    enum class ObjectType { Reflection, Widget, QuickItem };
+
+    static ObjectType resolveObjectType(const QObject *object);
+    static bool isTopLevelObject(const QObject *object, const ObjectType type);
+    static QObject *parentObject(const QObject *object, const ObjectType type);
+    static QRectF mapObjectRectToWindow(const QObject *object, const ObjectType type);
+    static bool containsPrecisely(const QObject *object,
+                                  const ObjectType type,
+                                  const QPointF &point);
+
+    bool resolveTopmost(const QPointF &point, bool *result) const;
+    void watch(const int index);
+    void unwatch(const QObject *object);
+    void release(const QObject *object);
+    void releaseWatches(const int index);
+    void markDirty(QObject *object, const bool reparented);
+    void update();
+    void rebuildGrid();
+
+    // An object watched for an entry, "position" is where the entry is in
+    // the dependents of the object.
+    struct Watch
+    {
+        const QObject *object = nullptr;
+        int position = -1;
+    };
+
+    // An entry depending on a watched object, "watch" is where the object
+    // is in the watches of the entry. The two back-indices make removing a
+    // dependency O(1) on both sides.
+    struct Dependent
+    {
+        int entry = -1;
+        int watch = -1;
+    };
+
+    struct Entry
+    {
+        QPointer<QObject> object = nullptr;
+        QRectF rect = {};
+        ObjectType type = ObjectType::Reflection;
+        bool dirty = true;
+        // Everything watch() has started watching for this entry.
+        QVector<Watch> watched = {};
+    };
+
+    void removeDependent(QVector<Dependent> &dependents, const int position);
+    void removeWatch(const int index, const int position);
+
+    // The entries of the objects which are gone are free, and recycled by
+    // addObject().
+    QVector<Entry> m_entries = {};
+    QVector<int> m_freeEntries = {};
+    QHash<const QObject *, int> m_entryIndices = {};
+    // Every watched object (the registered objects and their ancestors),
+    // mapped to the entries whose geometry depends on it.
+    QHash<const QObject *, QVector<Dependent>> m_dependents = {};
+    QRectF m_bounds = {};
+    qreal m_cellSize = 0.0;
+    int m_columns = 0, m_rows = 0;
+    // Compressed grid: the entries of cell "i" are
+    // m_cellEntries[m_cellStart[i] .. m_cellStart[i + 1]).
+    QVector<int> m_cellStart = {};
+    QVector<int> m_cellEntries = {};
+    bool m_dirty = true;
+    quint64 m_generation = 0;
+};
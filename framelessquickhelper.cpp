@@ -144,6 +144,17 @@ void FramelessQuickHelper::addIgnoreObject(QQuickItem *val)
     FramelessWindowsManager::addIgnoreObject(window(), val);
 }
 
+void FramelessQuickHelper::removeIgnoreObject(QQuickItem *val)
+{
+    Q_ASSERT(val);
+    FramelessWindowsManager::removeIgnoreObject(window(), val);
+}
+
+void FramelessQuickHelper::clearIgnoreObjects()
+{
+    FramelessWindowsManager::clearIgnoreObjects(window());
+}
+
 #ifdef Q_OS_WINDOWS
 void FramelessQuickHelper::timerEvent(QTimerEvent *event)
 {
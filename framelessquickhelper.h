@@ -97,6 +97,8 @@ public Q_SLOTS:
     void removeWindowFrame();
 
     void addIgnoreObject(QQuickItem *val);
+    void removeIgnoreObject(QQuickItem *val);
+    void clearIgnoreObjects();
 
 #ifdef Q_OS_WINDOWS
     void setWindowFrameVisible(const bool value = true);
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "framelessregionindex.h"
+#include <QTransform>
+#include <QtMath>
+#include <algorithm>
+
+void FramelessRegionIndex::addRegion(const QRegion &region)
+{
+    if (region.isEmpty()) {
+        return;
+    }
+    m_regions.append(region);
+    m_dirty = true;
+    ++m_generation;
+}
+
+void FramelessRegionIndex::addPath(const QPainterPath &path)
+{
+    if (path.isEmpty()) {
+        return;
+    }
+    m_paths.append(path);
+    m_dirty = true;
+    ++m_generation;
+}
+
+void FramelessRegionIndex::clear()
+{
+    m_regions.clear();
+    m_paths.clear();
+    m_dirty = true;
+    ++m_generation;
+}
+
+bool FramelessRegionIndex::isEmpty() const
+{
+    return m_regions.isEmpty() && m_paths.isEmpty();
+}
+
+quint64 FramelessRegionIndex::generation() const
+{
+    return m_generation;
+}
+
+bool FramelessRegionIndex::contains(const QPointF &point, const qreal devicePixelRatio) const
+{
+    if (isEmpty()) {
+        return false;
+    }
+    if (m_dirty || !qFuzzyCompare(m_devicePixelRatio, devicePixelRatio)) {
+        rebuild(devicePixelRatio);
+    }
+    const int x = qFloor(point.x() * devicePixelRatio);
+    const int y = qFloor(point.y() * devicePixelRatio);
+    const auto bandIt = std::upper_bound(m_bandTop.cbegin(), m_bandTop.cend(), y);
+    if (bandIt == m_bandTop.cbegin()) {
+        return false;
+    }
+    const int band = static_cast<int>(bandIt - m_bandTop.cbegin()) - 1;
+    if (y > m_bandBottom.at(band)) {
+        return false;
+    }
+    const auto first = m_spans.cbegin() + m_bandStart.at(band);
+    const auto last = m_spans.cbegin() + m_bandStart.at(band + 1);
+    const auto spanIt = std::upper_bound(first, last, x, [](const int value, const Span &span) {
+        return value < span.left;
+    });
+    return (spanIt != first) && (x <= (spanIt - 1)->right);
+}
+
+void FramelessRegionIndex::rebuild(const qreal devicePixelRatio) const
+{
+    m_dirty = false;
+    m_devicePixelRatio = devicePixelRatio;
+    m_bandTop.clear();
+    m_bandBottom.clear();
+    m_bandStart.clear();
+    m_spans.clear();
+    const QTransform transform = QTransform::fromScale(devicePixelRatio, devicePixelRatio);
+    QRegion device = {};
+    for (auto &&region : qAsConst(m_regions)) {
+        device += transform.map(region);
+    }
+    for (auto &&path : qAsConst(m_paths)) {
+        // toFillPolygon() would join all the subpaths into a single polygon,
+        // whose connecting edges break the winding fill. The polygons are
+        // already in device pixels when their points get rounded.
+        const QList<QPolygonF> polygons = path.toFillPolygons(transform);
+        for (auto &&polygon : polygons) {
+            device += QRegion(polygon.toPolygon(), path.fillRule());
+        }
+    }
+    // QRegion keeps its rectangles y-x banded: sorted by top, then by left,
+    // and the rectangles of one band share the same top and bottom.
+    for (const QRect &rect : device) {
+        if (m_bandTop.isEmpty() || (m_bandTop.last() != rect.top())) {
+            m_bandTop.append(rect.top());
+            m_bandBottom.append(rect.bottom());
+            m_bandStart.append(m_spans.size());
+        }
+        m_spans.append({rect.left(), rect.right()});
+    }
+    m_bandStart.append(m_spans.size());
+}
@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QPainterPath>
+#include <QRegion>
+#include <QVector>
+
+// A set of arbitrary shapes (rounded tabs, circular buttons and so on) in the
+// window's coordinate system, in logical pixels.
+//
+// The shapes are rasterized lazily at the device pixel ratio of the query into
+// a scanline band structure: a sorted list of horizontal bands, each one with
+// a sorted list of covered spans. A hit test is then two binary searches on
+// integers, whatever the complexity of the original paths. The bands are only
+// rebuilt after the shapes or the device pixel ratio have changed.
+class FRAMELESSHELPER_EXPORT FramelessRegionIndex
+{
+public:
+    explicit FramelessRegionIndex() = default;
+    ~FramelessRegionIndex() = default;
+
+    void addRegion(const QRegion &region);
+    void addPath(const QPainterPath &path);
+    void clear();
+    bool isEmpty() const;
+
+    // Bumped whenever the result of contains() may have changed.
+    quint64 generation() const;
+
+    bool contains(const QPointF &point, const qreal devicePixelRatio) const;
+
+private:
+    void rebuild(const qreal devicePixelRatio) const;
+
+    struct Span
+    {
+        int left = 0;
+        // Inclusive, like QRect::right().
+        int right = 0;
+    };
+
+    QVector<QRegion> m_regions = {};
+    QVector<QPainterPath> m_paths = {};
+    quint64 m_generation = 0;
+
+    // The rasterized shapes, in device pixels. The spans of band "i" are
+    // m_spans[m_bandStart[i] .. m_bandStart[i + 1]).
+    mutable QVector<int> m_bandTop = {};
+    mutable QVector<int> m_bandBottom = {};
+    mutable QVector<int> m_bandStart = {};
+    mutable QVector<Span> m_spans = {};
+    mutable qreal m_devicePixelRatio = 0.0;
+    mutable bool m_dirty = true;
+};
@@ -52,83 +52,165 @@ void FramelessWindowsManager::addIgnoreObject(const QWindow *window, QObject *ob
 {
     Q_ASSERT(window);
 #ifdef Q_OS_WINDOWS
-    QObjectList objects = WinNativeEventFilter::getIgnoredObjects(window);
-    objects.append(object);
-    WinNativeEventFilter::setIgnoredObjects(const_cast<QWindow *>(window), objects);
+    WinNativeEventFilter::addIgnoredObject(const_cast<QWindow *>(window), object);
 #else
     framelessHelper()->addIgnoreObject(window, object);
 #endif
 }
 
-int FramelessWindowsManager::getBorderWidth(const QWindow *window)
+void FramelessWindowsManager::addIgnoreObjects(const QWindow *window, const QObjectList &objects)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::addIgnoredObjects(const_cast<QWindow *>(window), objects);
+#else
+    framelessHelper()->addIgnoreObjects(window, objects);
+#endif
+}
+
+void FramelessWindowsManager::removeIgnoreObject(const QWindow *window, const QObject *object)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::removeIgnoredObject(window, object);
+#else
+    framelessHelper()->removeIgnoreObject(window, object);
+#endif
+}
+
+void FramelessWindowsManager::clearIgnoreObjects(const QWindow *window)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::clearIgnoredObjects(window);
+#else
+    framelessHelper()->clearIgnoreObjects(window);
+#endif
+}
+
+void FramelessWindowsManager::addIgnoreRegion(const QWindow *window, const QRegion &region)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::addIgnoredRegion(const_cast<QWindow *>(window), region);
+#else
+    framelessHelper()->addIgnoreRegion(window, region);
+#endif
+}
+
+void FramelessWindowsManager::addIgnorePath(const QWindow *window, const QPainterPath &path)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::addIgnoredPath(const_cast<QWindow *>(window), path);
+#else
+    framelessHelper()->addIgnorePath(window, path);
+#endif
+}
+
+void FramelessWindowsManager::addDragObject(const QWindow *window, QObject *object)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::addDragObject(const_cast<QWindow *>(window), object);
+#else
+    framelessHelper()->addDragObject(window, object);
+#endif
+}
+
+void FramelessWindowsManager::addDragRect(const QWindow *window, const QRectF &rect)
 {
+    Q_ASSERT(window);
 #ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::addDragRect(const_cast<QWindow *>(window), rect);
+#else
+    framelessHelper()->addDragRect(window, rect);
+#endif
+}
+
+bool FramelessWindowsManager::isDragAllowListEnabled(const QWindow *window)
+{
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    return WinNativeEventFilter::isDragAllowListEnabled(window);
+#else
+    return framelessHelper()->isDragAllowListEnabled(window);
+#endif
+}
+
+void FramelessWindowsManager::setDragAllowListEnabled(const QWindow *window, const bool value)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::setDragAllowListEnabled(const_cast<QWindow *>(window), value);
+#else
+    framelessHelper()->setDragAllowListEnabled(window, value);
+#endif
+}
+
+int FramelessWindowsManager::getBorderWidth(const QWindow *window)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     return WinNativeEventFilter::getSystemMetric(window,
                                                  WinNativeEventFilter::SystemMetric::BorderWidth,
                                                  false);
 #else
-    Q_UNUSED(window)
-    return framelessHelper()->getBorderWidth();
+    return framelessHelper()->getBorderWidth(window);
 #endif
 }
 
 void FramelessWindowsManager::setBorderWidth(const QWindow *window, const int value)
 {
-#ifdef Q_OS_WINDOWS
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     WinNativeEventFilter::setBorderWidth(const_cast<QWindow *>(window), value);
 #else
-    Q_UNUSED(window)
-    framelessHelper()->setBorderWidth(value);
+    framelessHelper()->setBorderWidth(window, value);
 #endif
 }
 
 int FramelessWindowsManager::getBorderHeight(const QWindow *window)
 {
-#ifdef Q_OS_WINDOWS
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     return WinNativeEventFilter::getSystemMetric(window,
                                                  WinNativeEventFilter::SystemMetric::BorderHeight,
                                                  false);
 #else
-    Q_UNUSED(window)
-    return framelessHelper()->getBorderHeight();
+    return framelessHelper()->getBorderHeight(window);
 #endif
 }
 
 void FramelessWindowsManager::setBorderHeight(const QWindow *window, const int value)
 {
-#ifdef Q_OS_WINDOWS
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     WinNativeEventFilter::setBorderHeight(const_cast<QWindow *>(window), value);
 #else
-    Q_UNUSED(window)
-    framelessHelper()->setBorderHeight(value);
+    framelessHelper()->setBorderHeight(window, value);
 #endif
 }
 
 int FramelessWindowsManager::getTitleBarHeight(const QWindow *window)
 {
-#ifdef Q_OS_WINDOWS
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     return WinNativeEventFilter::getSystemMetric(window,
                                                  WinNativeEventFilter::SystemMetric::TitleBarHeight,
                                                  false);
 #else
-    Q_UNUSED(window)
-    return framelessHelper()->getTitleBarHeight();
+    return framelessHelper()->getTitleBarHeight(window);
 #endif
 }
 
 void FramelessWindowsManager::setTitleBarHeight(const QWindow *window, const int value)
 {
-#ifdef Q_OS_WINDOWS
     Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
     WinNativeEventFilter::setTitleBarHeight(const_cast<QWindow *>(window), value);
 #else
-    Q_UNUSED(window)
-    framelessHelper()->setTitleBarHeight(value);
+    framelessHelper()->setTitleBarHeight(window, value);
 #endif
 }
 
@@ -136,15 +218,7 @@ bool FramelessWindowsManager::getResizable(const QWindow *window)
 {
     Q_ASSERT(window);
 #ifdef Q_OS_WINDOWS
-    if (window->flags().testFlag(Qt::MSWindowsFixedSizeDialogHint)) {
-        return false;
-    }
-    const QSize minSize = window->minimumSize();
-    const QSize maxSize = window->maximumSize();
-    if (!minSize.isEmpty() && !maxSize.isEmpty() && minSize == maxSize) {
-        return false;
-    }
-    return true;
+    return WinNativeEventFilter::isWindowResizable(window);
 #else
     return framelessHelper()->getResizable(window);
 #endif
@@ -154,8 +228,50 @@ void FramelessWindowsManager::setResizable(const QWindow *window, const bool val
 {
     Q_ASSERT(window);
 #ifdef Q_OS_WINDOWS
-    const_cast<QWindow *>(window)->setFlag(Qt::MSWindowsFixedSizeDialogHint, !value);
+    WinNativeEventFilter::setWindowResizable(const_cast<QWindow *>(window), value);
 #else
     framelessHelper()->setResizable(window, value);
 #endif
 }
+
+TitleBarRegionMap FramelessWindowsManager::getTitleBarRegionMap(const QWindow *window)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    return WinNativeEventFilter::getTitleBarRegionMap(window);
+#else
+    return framelessHelper()->getTitleBarRegionMap(window);
+#endif
+}
+
+void FramelessWindowsManager::setTitleBarRegionMap(const QWindow *window,
+                                                   const TitleBarRegionMap &map)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::setTitleBarRegionMap(const_cast<QWindow *>(window), map);
+#else
+    framelessHelper()->setTitleBarRegionMap(window, map);
+#endif
+}
+
+HitTestEngine::Callback FramelessWindowsManager::getHitTestCallback(const QWindow *window)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    return WinNativeEventFilter::getHitTestCallback(window);
+#else
+    return framelessHelper()->getHitTestCallback(window);
+#endif
+}
+
+void FramelessWindowsManager::setHitTestCallback(const QWindow *window,
+                                                 const HitTestEngine::Callback &callback)
+{
+    Q_ASSERT(window);
+#ifdef Q_OS_WINDOWS
+    WinNativeEventFilter::setHitTestCallback(const_cast<QWindow *>(window), callback);
+#else
+    framelessHelper()->setHitTestCallback(window, callback);
+#endif
+}
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "framelesshelper_global.h"
+#include "titlebarregionmap.h"
 #include <QRect>
 
 #if (defined(Q_OS_WIN) || defined(Q_OS_WIN32) || defined(Q_OS_WIN64) || defined(Q_OS_WINRT)) \
@@ -34,6 +35,8 @@
 
 QT_BEGIN_NAMESPACE
 QT_FORWARD_DECLARE_CLASS(QObject)
+QT_FORWARD_DECLARE_CLASS(QPainterPath)
+QT_FORWARD_DECLARE_CLASS(QRegion)
 QT_FORWARD_DECLARE_CLASS(QWindow)
 QT_END_NAMESPACE
 
@@ -58,6 +61,17 @@ public:
     static void addWindow(const QWindow *window);
 
     static void addIgnoreObject(const QWindow *window, QObject *object);
+    static void addIgnoreObjects(const QWindow *window, const QObjectList &objects);
+    static void removeIgnoreObject(const QWindow *window, const QObject *object);
+    static void clearIgnoreObjects(const QWindow *window);
+    static void addIgnoreRegion(const QWindow *window, const QRegion &region);
+    static void addIgnorePath(const QWindow *window, const QPainterPath &path);
+
+    static void addDragObject(const QWindow *window, QObject *object);
+    static void addDragRect(const QWindow *window, const QRectF &rect);
+
+    static bool isDragAllowListEnabled(const QWindow *window);
+    static void setDragAllowListEnabled(const QWindow *window, const bool value = true);
 
     static int getBorderWidth(const QWindow *window);
     static void setBorderWidth(const QWindow *window, const int value);
@@ -70,4 +84,13 @@ public:
 
     static bool getResizable(const QWindow *window);
     static void setResizable(const QWindow *window, const bool value = true);
+
+    static TitleBarRegionMap getTitleBarRegionMap(const QWindow *window);
+    static void setTitleBarRegionMap(const QWindow *window, const TitleBarRegionMap &map);
+
+    // Classify the points of the window in code, before any other rule.
+    // Useful when the interactive parts of the title bar follow a simple
+    // pattern, like the tabs of a tab strip.
+    static HitTestEngine::Callback getHitTestCallback(const QWindow *window);
+    static void setHitTestCallback(const QWindow *window, const HitTestEngine::Callback &callback);
 };
@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QHash>
+#include <QVector>
+#include <deque>
+
+// Per-window state storage shared by the back ends. The records live in a
+// pool of slots which never moves them around (so a pointer to a record
+// stays valid until it's removed), freed slots are recycled, and a hash maps
+// the keys to the slots. Events tend to come in bursts for the same window,
+// so the last lookup is remembered and a repeated one doesn't even hash.
+template <typename Key, typename T>
+class FramelessWindowStore
+{
+public:
+    explicit FramelessWindowStore() = default;
+    ~FramelessWindowStore() = default;
+
+    T *find(const Key &key)
+    {
+        const int index = indexOf(key);
+        return (index >= 0) ? &m_slots[index].value : nullptr;
+    }
+
+    const T *find(const Key &key) const
+    {
+        const int index = indexOf(key);
+        return (index >= 0) ? &m_slots[index].value : nullptr;
+    }
+
+    // "inserted" tells whether the record has just been created.
+    T &findOrInsert(const Key &key, bool *inserted = nullptr)
+    {
+        int index = indexOf(key);
+        if (inserted) {
+            *inserted = (index < 0);
+        }
+        if (index < 0) {
+            if (m_freeSlots.isEmpty()) {
+                index = static_cast<int>(m_slots.size());
+                m_slots.emplace_back();
+            } else {
+                index = m_freeSlots.takeLast();
+            }
+            m_slots[index].key = key;
+            m_slots[index].used = true;
+            m_indices.insert(key, index);
+            m_lastKey = key;
+            m_lastIndex = index;
+        }
+        return m_slots[index].value;
+    }
+
+    void remove(const Key &key)
+    {
+        const auto it = m_indices.find(key);
+        if (it == m_indices.end()) {
+            return;
+        }
+        const int index = it.value();
+        m_indices.erase(it);
+        m_slots[index] = {};
+        m_freeSlots.append(index);
+        if (m_lastIndex == index) {
+            m_lastIndex = -1;
+        }
+    }
+
+    int size() const { return m_indices.size(); }
+    bool isEmpty() const { return m_indices.isEmpty(); }
+
+    template <typename Function>
+    void forEach(Function function)
+    {
+        for (auto &&slot : m_slots) {
+            if (slot.used) {
+                function(slot.key, slot.value);
+            }
+        }
+    }
+
+    template <typename Function>
+    void forEach(Function function) const
+    {
+        for (auto &&slot : m_slots) {
+            if (slot.used) {
+                function(slot.key, slot.value);
+            }
+        }
+    }
+
+private:
+    int indexOf(const Key &key) const
+    {
+        if ((m_lastIndex >= 0) && (m_lastKey == key)) {
+            return m_lastIndex;
+        }
+        const int index = m_indices.value(key, -1);
+        if (index >= 0) {
+            m_lastKey = key;
+            m_lastIndex = index;
+        }
+        return index;
+    }
+
+    struct Slot
+    {
+        Key key = {};
+        T value = {};
+        bool used = false;
+    };
+
+    std::deque<Slot> m_slots = {};
+    QVector<int> m_freeSlots = {};
+    QHash<Key, int> m_indices = {};
+    mutable Key m_lastKey = {};
+    mutable int m_lastIndex = -1;
+};
@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hittestengine.h"
+#include <limits>
+
+#ifndef QT_COORD_TYPE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define HTE_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define HTE_USE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace {
+
+using Region = HitTestEngine::Region;
+
+// Indexed by [none, top, bottom][none, left, right].
+constexpr Region m_edgeRegions[3][3] = {{Region::Client, Region::Left, Region::Right},
+                                        {Region::Top, Region::TopLeft, Region::TopRight},
+                                        {Region::Bottom, Region::BottomLeft, Region::BottomRight}};
+
+// The batch version doesn't branch on the edges it is responsible for: a
+// disabled edge simply gets a threshold no point can reach. The comparison
+// results are packed into a 5 bits key which is then looked up in a table
+// built once per call.
+struct Thresholds
+{
+    qreal top, bottom;
+    // [0]: normal border width, [1]: doubled border width (corners).
+    qreal left[2], right[2];
+    qreal titleBar;
+};
+
+enum KeyBit { Top = 1, Bottom = 2, Left = 4, Right = 8, Caption = 16 };
+constexpr int m_keyCount = 32;
+
+Thresholds getThresholds(const HitTestEngine::Metrics &metrics)
+{
+    const qreal inf = std::numeric_limits<qreal>::infinity();
+    const Qt::Edges edges = metrics.maximized ? Qt::Edges{} : metrics.resizeEdges;
+    const qreal bw = metrics.borderWidth;
+    const qreal ww = metrics.windowWidth;
+    Thresholds thresholds = {};
+    thresholds.top = edges.testFlag(Qt::TopEdge) ? metrics.borderHeight : -inf;
+    thresholds.bottom = edges.testFlag(Qt::BottomEdge)
+                            ? (metrics.windowHeight - metrics.borderHeight)
+                            : inf;
+    const bool hasLeft = edges.testFlag(Qt::LeftEdge);
+    thresholds.left[0] = hasLeft ? bw : -inf;
+    thresholds.left[1] = hasLeft ? (bw * 2) : -inf;
+    const bool hasRight = edges.testFlag(Qt::RightEdge);
+    thresholds.right[0] = hasRight ? (ww - bw) : inf;
+    thresholds.right[1] = hasRight ? (ww - (bw * 2)) : inf;
+    thresholds.titleBar = metrics.titleBarHeight;
+    return thresholds;
+}
+
+void getKeyTable(const HitTestEngine::Metrics &metrics, Region *table)
+{
+    Q_ASSERT(table);
+    for (int key = 0; key != m_keyCount; ++key) {
+        const int row = (key & KeyBit::Top) ? 1 : ((key & KeyBit::Bottom) ? 2 : 0);
+        const int column = (key & KeyBit::Left) ? 1 : ((key & KeyBit::Right) ? 2 : 0);
+        const Region region = m_edgeRegions[row][column];
+        if (region != Region::Client) {
+            table[key] = metrics.fixedSize ? Region::FixedBorder : region;
+        } else {
+            table[key] = (key & KeyBit::Caption) ? Region::Caption : Region::Client;
+        }
+    }
+}
+
+inline int getKey(const Thresholds &thresholds, const qreal x, const qreal y)
+{
+    const bool isTop = y <= thresholds.top;
+    const bool isBottom = y >= thresholds.bottom;
+    const int corner = (isTop || isBottom) ? 1 : 0;
+    return (isTop ? KeyBit::Top : 0) | (isBottom ? KeyBit::Bottom : 0)
+           | ((x <= thresholds.left[corner]) ? KeyBit::Left : 0)
+           | ((x >= thresholds.right[corner]) ? KeyBit::Right : 0)
+           | ((y <= thresholds.titleBar) ? KeyBit::Caption : 0);
+}
+
+#ifdef HTE_USE_SSE2
+int classifySse2(const Thresholds &thresholds,
+                 const Region *table,
+                 const qreal *xs,
+                 const qreal *ys,
+                 Region *regions,
+                 const int count)
+{
+    const __m128d top = _mm_set1_pd(thresholds.top);
+    const __m128d bottom = _mm_set1_pd(thresholds.bottom);
+    const __m128d left = _mm_set1_pd(thresholds.left[0]);
+    const __m128d cornerLeft = _mm_set1_pd(thresholds.left[1]);
+    const __m128d right = _mm_set1_pd(thresholds.right[0]);
+    const __m128d cornerRight = _mm_set1_pd(thresholds.right[1]);
+    const __m128d titleBar = _mm_set1_pd(thresholds.titleBar);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d x = _mm_loadu_pd(xs + i);
+        const __m128d y = _mm_loadu_pd(ys + i);
+        const __m128d isTop = _mm_cmple_pd(y, top);
+        const __m128d isBottom = _mm_cmpge_pd(y, bottom);
+        const __m128d isCorner = _mm_or_pd(isTop, isBottom);
+        const __m128d leftLimit = _mm_or_pd(_mm_and_pd(isCorner, cornerLeft),
+                                            _mm_andnot_pd(isCorner, left));
+        const __m128d rightLimit = _mm_or_pd(_mm_and_pd(isCorner, cornerRight),
+                                             _mm_andnot_pd(isCorner, right));
+        const int t = _mm_movemask_pd(isTop);
+        const int b = _mm_movemask_pd(isBottom);
+        const int l = _mm_movemask_pd(_mm_cmple_pd(x, leftLimit));
+        const int r = _mm_movemask_pd(_mm_cmpge_pd(x, rightLimit));
+        const int c = _mm_movemask_pd(_mm_cmple_pd(y, titleBar));
+        // Bit "n" of every mask belongs to lane "n".
+        regions[i] = table[(t & 1) | ((b & 1) << 1) | ((l & 1) << 2) | ((r & 1) << 3)
+                           | ((c & 1) << 4)];
+        regions[i + 1] = table[(t >> 1) | ((b >> 1) << 1) | ((l >> 1) << 2) | ((r >> 1) << 3)
+                               | ((c >> 1) << 4)];
+    }
+    return i;
+}
+#endif
+
+#ifdef HTE_USE_NEON
+int classifyNeon(const Thresholds &thresholds,
+                 const Region *table,
+                 const qreal *xs,
+                 const qreal *ys,
+                 Region *regions,
+                 const int count)
+{
+    const float64x2_t top = vdupq_n_f64(thresholds.top);
+    const float64x2_t bottom = vdupq_n_f64(thresholds.bottom);
+    const float64x2_t left = vdupq_n_f64(thresholds.left[0]);
+    const float64x2_t cornerLeft = vdupq_n_f64(thresholds.left[1]);
+    const float64x2_t right = vdupq_n_f64(thresholds.right[0]);
+    const float64x2_t cornerRight = vdupq_n_f64(thresholds.right[1]);
+    const float64x2_t titleBar = vdupq_n_f64(thresholds.titleBar);
+    // Turns the all-ones/all-zeros lanes of a mask into the given key bit.
+    const auto toBits = [](const uint64x2_t mask, const uint64_t bit) {
+        return vandq_u64(mask, vdupq_n_u64(bit));
+    };
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const float64x2_t x = vld1q_f64(xs + i);
+        const float64x2_t y = vld1q_f64(ys + i);
+        const uint64x2_t isTop = vcleq_f64(y, top);
+        const uint64x2_t isBottom = vcgeq_f64(y, bottom);
+        const uint64x2_t isCorner = vorrq_u64(isTop, isBottom);
+        const float64x2_t leftLimit = vbslq_f64(isCorner, cornerLeft, left);
+        const float64x2_t rightLimit = vbslq_f64(isCorner, cornerRight, right);
+        uint64x2_t keys = toBits(isTop, KeyBit::Top);
+        keys = vorrq_u64(keys, toBits(isBottom, KeyBit::Bottom));
+        keys = vorrq_u64(keys, toBits(vcleq_f64(x, leftLimit), KeyBit::Left));
+        keys = vorrq_u64(keys, toBits(vcgeq_f64(x, rightLimit), KeyBit::Right));
+        keys = vorrq_u64(keys, toBits(vcleq_f64(y, titleBar), KeyBit::Caption));
+        regions[i] = table[vgetq_lane_u64(keys, 0)];
+        regions[i + 1] = table[vgetq_lane_u64(keys, 1)];
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+HitTestEngine::Region HitTestEngine::classify(const Metrics &metrics, const qreal x, const qreal y)
+{
+    if (!metrics.maximized) {
+        const Qt::Edges edges = metrics.resizeEdges;
+        const bool isTop = edges.testFlag(Qt::TopEdge) && (y <= metrics.borderHeight);
+        const bool isBottom = edges.testFlag(Qt::BottomEdge)
+                              && (y >= (metrics.windowHeight - metrics.borderHeight));
+        // Make the border a little wider to let the user easy to resize
+        // on corners.
+        const int bw = metrics.borderWidth * ((isTop || isBottom) ? 2 : 1);
+        const bool isLeft = edges.testFlag(Qt::LeftEdge) && (x <= bw);
+        const bool isRight = edges.testFlag(Qt::RightEdge) && (x >= (metrics.windowWidth - bw));
+        const Region region = m_edgeRegions[isTop ? 1 : (isBottom ? 2 : 0)]
+                                           [isLeft ? 1 : (isRight ? 2 : 0)];
+        if (region != Region::Client) {
+            return metrics.fixedSize ? Region::FixedBorder : region;
+        }
+    }
+    return (y <= metrics.titleBarHeight) ? Region::Caption : Region::Client;
+}
+
+void HitTestEngine::classify(
+    const Metrics &metrics, const qreal *xs, const qreal *ys, Region *regions, const int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    Q_ASSERT(xs);
+    Q_ASSERT(ys);
+    Q_ASSERT(regions);
+    const Thresholds thresholds = getThresholds(metrics);
+    Region table[m_keyCount];
+    getKeyTable(metrics, table);
+    int i = 0;
+#if defined(HTE_USE_SSE2)
+    i = classifySse2(thresholds, table, xs, ys, regions, count);
+#elif defined(HTE_USE_NEON)
+    i = classifyNeon(thresholds, table, xs, ys, regions, count);
+#endif
+    for (; i != count; ++i) {
+        regions[i] = table[getKey(thresholds, xs[i], ys[i])];
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QtCore/qnamespace.h>
+#include <QtCore/qpoint.h>
+#include <functional>
+
+// Decides which part of a frameless window a point belongs to: one of the
+// resize edges, the title bar or the client area. It only deals with plain
+// numbers, so FramelessHelper and WinNativeEventFilter share exactly the same
+// rules, and it doesn't need a window (or even a GUI application) to run.
+class FRAMELESSHELPER_EXPORT HitTestEngine
+{
+public:
+    enum class Region : quint8 {
+        Client = 0,
+        Caption,
+        Top,
+        Bottom,
+        Left,
+        Right,
+        TopLeft,
+        TopRight,
+        BottomLeft,
+        BottomRight,
+        // A window edge which can't be used to resize the window.
+        FixedBorder
+    };
+    static constexpr int regionCount = static_cast<int>(Region::FixedBorder) + 1;
+
+    // Lets the application classify the points of a window itself, before
+    // any other rule. "point" is in the window's coordinate system, in
+    // logical pixels. Returning false falls through to the usual hit test.
+    using Callback = std::function<bool(const QPointF &point, Region *region)>;
+
+    struct Metrics
+    {
+        // All the values must be in the same unit as the point to classify.
+        int windowWidth = 0;
+        int windowHeight = 0;
+        int borderWidth = 0;
+        int borderHeight = 0;
+        int titleBarHeight = 0;
+        // The edges we are responsible for, the other ones are handled by
+        // the system (if it still draws the window frame).
+        Qt::Edges resizeEdges = Qt::TopEdge | Qt::BottomEdge | Qt::LeftEdge | Qt::RightEdge;
+        // Maximized and full screen windows can't be resized by their edges.
+        bool maximized = false;
+        bool fixedSize = false;
+    };
+
+    // The ignore objects are not taken into account here, the caller should
+    // turn "Caption" into "Client" if the point is inside one of them.
+    static Region classify(const Metrics &metrics, const qreal x, const qreal y);
+    // Classifies "count" points at once, the coordinates are passed as two
+    // separate arrays so they can be loaded straight into vector registers.
+    // Gives exactly the same results as the single point version.
+    static void classify(const Metrics &metrics,
+                         const qreal *xs,
+                         const qreal *ys,
+                         Region *regions,
+                         const int count);
+
+    static constexpr Qt::Edges toEdges(const Region region)
+    {
+        return m_edges[static_cast<int>(region)];
+    }
+
+    static constexpr Qt::CursorShape toCursorShape(const Region region)
+    {
+        return m_cursorShapes[static_cast<int>(region)];
+    }
+
+private:
+    static constexpr Qt::Edges m_edges[regionCount] = {{},
+                                                       {},
+                                                       Qt::TopEdge,
+                                                       Qt::BottomEdge,
+                                                       Qt::LeftEdge,
+                                                       Qt::RightEdge,
+                                                       Qt::TopEdge | Qt::LeftEdge,
+                                                       Qt::TopEdge | Qt::RightEdge,
+                                                       Qt::BottomEdge | Qt::LeftEdge,
+                                                       Qt::BottomEdge | Qt::RightEdge,
+                                                       {}};
+
+    static constexpr Qt::CursorShape m_cursorShapes[regionCount] = {Qt::ArrowCursor,
+                                                                    Qt::ArrowCursor,
+                                                                    Qt::SizeVerCursor,
+                                                                    Qt::SizeVerCursor,
+                                                                    Qt::SizeHorCursor,
+                                                                    Qt::SizeHorCursor,
+                                                                    Qt::SizeFDiagCursor,
+                                                                    Qt::SizeBDiagCursor,
+                                                                    Qt::SizeBDiagCursor,
+                                                                    Qt::SizeFDiagCursor,
+                                                                    Qt::ArrowCursor};
+};
+
+// Remembers the last few hit test results of one window. The platforms tend
+// to ask for the same point again and again (WM_NCHITTEST is sent several
+// times per mouse move, Qt repeats mouse moves with identical coordinates),
+// so a hit here saves the whole classification, including the system metric
+// queries and the ignore object lookup.
+//
+// "generation" must change whenever anything the result depends on changes,
+// the caller usually sums up monotonic counters. clear() drops everything.
+class FRAMELESSHELPER_EXPORT HitTestCache
+{
+public:
+    bool lookup(const qreal x,
+                const qreal y,
+                const quint64 generation,
+                HitTestEngine::Region *region)
+    {
+        Q_ASSERT(region);
+        for (auto &&entry : m_entries) {
+            if (entry.valid && (entry.x == x) && (entry.y == y)
+                && (entry.generation == generation)) {
+                *region = entry.region;
+                ++m_hits;
+                return true;
+            }
+        }
+        ++m_misses;
+        return false;
+    }
+
+    void insert(const qreal x,
+                const qreal y,
+                const quint64 generation,
+                const HitTestEngine::Region region)
+    {
+        m_entries[m_next] = {x, y, generation, region, true};
+        m_next = (m_next + 1) % m_entryCount;
+    }
+
+    void clear()
+    {
+        for (auto &&entry : m_entries) {
+            entry.valid = false;
+        }
+    }
+
+    quint64 hits() const { return m_hits; }
+    quint64 misses() const { return m_misses; }
+
+private:
+    static constexpr int m_entryCount = 4;
+
+    struct Entry
+    {
+        qreal x = 0.0;
+        qreal y = 0.0;
+        quint64 generation = 0;
+        HitTestEngine::Region region = HitTestEngine::Region::Client;
+        bool valid = false;
+    };
+
+    Entry m_entries[m_entryCount] = {};
+    int m_next = 0;
+    quint64 m_hits = 0, m_misses = 0;
+};
@@ -3,6 +3,8 @@ TEMPLATE = lib
 win32: DLLDESTDIR = $$OUT_PWD/bin
 else: unix: DESTDIR = $$OUT_PWD/bin
 QT += gui-private
+qtHaveModule(widgets): QT += widgets
+qtHaveModule(quick): QT += quick
 CONFIG += c++17 strict_c++ utf8_source warn_on
 DEFINES += \
     QT_NO_CAST_FROM_ASCII \
@@ -11,9 +13,28 @@ DEFINES += \
 HEADERS += \
     framelesshelper_global.h \
     framelesshelper.h \
+    screentopology.h \
+    framelessobjectindex.h \
+    framelessregionindex.h \
+    framelesswindowstore.h \
+    hittestengine.h \
+    systemmetriccache.h \
+    titlebarregionmap.h \
+    titlebarareas.h \
+    touchgesturerecognizer.h \
+    windowsnapper.h \
     framelesswindowsmanager.h
 SOURCES += \
     framelesshelper.cpp \
+    screentopology.cpp \
+    framelessobjectindex.cpp \
+    framelessregionindex.cpp \
+    hittestengine.cpp \
+    systemmetriccache.cpp \
+    titlebarregionmap.cpp \
+    titlebarareas.cpp \
+    touchgesturerecognizer.cpp \
+    windowsnapper.cpp \
     framelesswindowsmanager.cpp
 win32 {
     DEFINES += WIN32_LEAN_AND_MEAN _CRT_SECURE_NO_WARNINGS
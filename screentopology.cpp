@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "screentopology.h"
+#include <QGuiApplication>
+#include <QScreen>
+
+ScreenTopology::ScreenTopology(QObject *parent) : QObject(parent)
+{
+    connect(qApp, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
+        watch(screen);
+        invalidate();
+    });
+    connect(qApp, &QGuiApplication::screenRemoved, this, &ScreenTopology::invalidate);
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (auto &&screen : qAsConst(screens)) {
+        watch(screen);
+    }
+}
+
+void ScreenTopology::watch(QScreen *screen)
+{
+    Q_ASSERT(screen);
+    connect(screen, &QScreen::geometryChanged, this, &ScreenTopology::invalidate);
+    connect(screen, &QScreen::availableGeometryChanged, this, &ScreenTopology::invalidate);
+    // The device pixel ratio follows the logical DPI.
+    connect(screen, &QScreen::logicalDotsPerInchChanged, this, &ScreenTopology::invalidate);
+}
+
+void ScreenTopology::invalidate()
+{
+    m_dirty = true;
+    ++m_generation;
+}
+
+quint64 ScreenTopology::generation() const
+{
+    return m_generation;
+}
+
+const QVector<WindowSnapper::Screen> &ScreenTopology::screens()
+{
+    if (m_dirty) {
+        m_screens.clear();
+        const QList<QScreen *> screens = QGuiApplication::screens();
+        m_screens.reserve(screens.size());
+        for (auto &&screen : qAsConst(screens)) {
+            m_screens.append(
+                {screen->geometry(), screen->availableGeometry(), screen->devicePixelRatio()});
+        }
+        m_dirty = false;
+    }
+    return m_screens;
+}
@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include "windowsnapper.h"
+#include <QObject>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QScreen)
+QT_END_NAMESPACE
+
+// A snapshot of the screens of the application: geometry, available
+// geometry and device pixel ratio of each one. Asking QGuiApplication and
+// QScreen for these on every step of a window move is not free, so they are
+// read once and only read again after a screen has been added, removed or
+// changed.
+class ScreenTopology : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ScreenTopology)
+
+public:
+    explicit ScreenTopology(QObject *parent = nullptr);
+    ~ScreenTopology() override = default;
+
+    const QVector<WindowSnapper::Screen> &screens();
+    // Bumped whenever the snapshot is invalidated.
+    quint64 generation() const;
+
+private Q_SLOTS:
+    void invalidate();
+
+private:
+    void watch(QScreen *screen);
+
+    QVector<WindowSnapper::Screen> m_screens = {};
+    bool m_dirty = true;
+    quint64 m_generation = 0;
+};
@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "systemmetriccache.h"
+
+namespace {
+
+const quint32 m_defaultDotsPerInch = 96;
+
+} // namespace
+
+SystemMetricCache::SystemMetricCache(const Provider *provider) : m_provider(provider)
+{
+    Q_ASSERT(m_provider);
+}
+
+void SystemMetricCache::clearValues(Entry &entry)
+{
+    for (auto &&byForce : entry.values) {
+        for (auto &&byDpiAware : byForce) {
+            for (auto &&value : byDpiAware) {
+                value = -1;
+            }
+        }
+    }
+}
+
+int SystemMetricCache::getUserValue(const void *window, const Metric metric) const
+{
+    Q_ASSERT(window);
+    const auto it = m_entries.constFind(window);
+    return (it != m_entries.constEnd()) ? it->userValues[static_cast<int>(metric)] : 0;
+}
+
+void SystemMetricCache::setUserValue(const void *window, const Metric metric, const int value)
+{
+    Q_ASSERT(window);
+    Entry &entry = m_entries[window];
+    entry.userValues[static_cast<int>(metric)] = value;
+    // The title bar height depends on the border height.
+    entry.valid = false;
+}
+
+int SystemMetricCache::getValue(const void *window,
+                                const Metric metric,
+                                const quint32 dpi,
+                                const bool dpiAware,
+                                const bool forceSystemValue)
+{
+    Q_ASSERT(window);
+    Entry &entry = m_entries[window];
+    if (!entry.valid || (entry.dpi != dpi)) {
+        clearValues(entry);
+        entry.dpi = dpi;
+        entry.valid = true;
+    }
+    const int value = entry.values[forceSystemValue ? 1 : 0][dpiAware ? 1 : 0]
+                                  [static_cast<int>(metric)];
+    if (value >= 0) {
+        ++m_hits;
+        return value;
+    }
+    ++m_misses;
+    return computeValue(window, entry, metric, dpiAware, forceSystemValue);
+}
+
+int SystemMetricCache::computeValue(const void *window,
+                                    Entry &entry,
+                                    const Metric metric,
+                                    const bool dpiAware,
+                                    const bool forceSystemValue)
+{
+    Q_ASSERT(window);
+    const int index = static_cast<int>(metric);
+    const qreal scale = dpiAware ? (qreal(entry.dpi) / qreal(m_defaultDotsPerInch)) : 1.0;
+    int ret = 0;
+    const int userValue = entry.userValues[index];
+    if ((userValue > 0) && !forceSystemValue) {
+        // The user defined title bar height already includes the border.
+        ret = qRound(userValue * scale);
+    } else {
+        const int systemValue = m_provider->getSystemMetric(metric, entry.dpi, dpiAware);
+        ret = (systemValue > 0) ? systemValue : qRound(defaultValues[index] * scale);
+        if (metric == Metric::TitleBarHeight) {
+            // When the scale factor is 1.0 (96 DPI): 23px of caption and
+            // 8px of border, 31px in total.
+            ret += getValue(window, Metric::BorderHeight, entry.dpi, dpiAware);
+        }
+    }
+    entry.values[forceSystemValue ? 1 : 0][dpiAware ? 1 : 0][index] = ret;
+    return ret;
+}
+
+void SystemMetricCache::invalidate(const void *window)
+{
+    Q_ASSERT(window);
+    const auto it = m_entries.find(window);
+    if (it != m_entries.end()) {
+        it->valid = false;
+    }
+}
+
+void SystemMetricCache::invalidate()
+{
+    for (auto &&entry : m_entries) {
+        entry.valid = false;
+    }
+}
+
+void SystemMetricCache::removeWindow(const void *window)
+{
+    Q_ASSERT(window);
+    m_entries.remove(window);
+}
@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QHash>
+
+// Remembers the border and title bar metrics of each window, so the hit
+// test reads precomputed integers instead of asking the system (and
+// re-deriving the values) several times per message.
+//
+// The system values come from a Provider, which is the only platform
+// specific part: WinNativeEventFilter plugs GetSystemMetricsForDpi() in, a
+// fake one can be used anywhere else. The values are computed for the DPI
+// of the window and dropped as soon as it asks for another one; the owner
+// also drops them on DPI, settings and theme changes.
+class FRAMELESSHELPER_EXPORT SystemMetricCache
+{
+public:
+    enum class Metric : quint8 { BorderWidth = 0, BorderHeight, TitleBarHeight };
+    static constexpr int metricCount = static_cast<int>(Metric::TitleBarHeight) + 1;
+
+    // Used when neither the user nor the system gives us anything, in device
+    // independent pixels.
+    static constexpr int defaultValues[metricCount] = {8, 8, 31};
+
+    class Provider
+    {
+    public:
+        virtual ~Provider() = default;
+
+        // The system value of "metric" for a window at "dpi" (96 means a
+        // scale factor of 1.0), in physical pixels if "dpiAware" is true and
+        // in device independent pixels otherwise. The title bar height is
+        // the caption alone, without the border above it. Anything below 1
+        // means "not available".
+        virtual int getSystemMetric(const Metric metric,
+                                    const quint32 dpi,
+                                    const bool dpiAware) const = 0;
+    };
+
+    explicit SystemMetricCache(const Provider *provider);
+    ~SystemMetricCache() = default;
+
+    // In device independent pixels, 0 or less means "use the system value".
+    int getUserValue(const void *window, const Metric metric) const;
+    void setUserValue(const void *window, const Metric metric, const int value);
+
+    int getValue(const void *window,
+                 const Metric metric,
+                 const quint32 dpi,
+                 const bool dpiAware,
+                 const bool forceSystemValue = false);
+
+    // Drops the computed values of one window (its DPI changed) or of all
+    // of them (the system settings changed). The user values stay.
+    void invalidate(const void *window);
+    void invalidate();
+    void removeWindow(const void *window);
+
+    quint64 hits() const { return m_hits; }
+    quint64 misses() const { return m_misses; }
+
+private:
+    // Indexed by [forceSystemValue][dpiAware][metric], -1 means "not
+    // computed yet".
+    using Values = int[2][2][metricCount];
+
+    struct Entry
+    {
+        int userValues[metricCount] = {};
+        // The DPI "values" have been computed for.
+        quint32 dpi = 0;
+        bool valid = false;
+        Values values = {};
+    };
+
+    static void clearValues(Entry &entry);
+    int computeValue(const void *window,
+                     Entry &entry,
+                     const Metric metric,
+                     const bool dpiAware,
+                     const bool forceSystemValue);
+
+    const Provider *m_provider = nullptr;
+    QHash<const void *, Entry> m_entries = {};
+    quint64 m_hits = 0, m_misses = 0;
+};
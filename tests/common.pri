@@ -0,0 +1,16 @@
+TEMPLATE = app
+DESTDIR = $$OUT_PWD/../../bin
+QT += testlib
+CONFIG += c++17 strict_c++ utf8_source warn_on testcase console
+CONFIG -= app_bundle
+DEFINES += \
+    QT_NO_CAST_FROM_ASCII \
+    QT_NO_CAST_TO_ASCII
+INCLUDEPATH += $$PWD/.. $$PWD/shared
+win32 {
+    CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../../debug -lFramelessHelperd
+    else: CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../../release -lFramelessHelper
+} else: unix {
+    LIBS += -L$$OUT_PWD/../../bin -lFramelessHelper
+    QMAKE_RPATHDIR += $$OUT_PWD/../../bin
+}
@@ -0,0 +1,3 @@
+TARGET = tst_framelesshelper
+include(../common.pri)
+SOURCES += tst_framelesshelper.cpp
@@ -0,0 +1,710 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "allocationcounter.h"
+#include "framelesshelper.h"
+#include "guitestmain.h"
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QPainterPath>
+#include <QPointer>
+#include <QRegion>
+#include <QScreen>
+#include <QWindow>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Gives the tests access to the event filter itself, so they only measure
+// what the helper does and not the event delivery of Qt.
+class TestHelper : public FramelessHelper
+{
+public:
+    using FramelessHelper::eventFilter;
+};
+
+using MouseEvents = std::vector<std::unique_ptr<QMouseEvent>>;
+
+// Mouse moves along the title bar of "window", built beforehand since
+// building an event may allocate.
+MouseEvents getTitleBarMoves(const QWindow &window, const int count)
+{
+    MouseEvents events;
+    for (int i = 0; i != count; ++i) {
+        const QPoint pos = {100 + i, 15};
+        events.push_back(std::make_unique<QMouseEvent>(QEvent::MouseMove,
+                                                       QPointF(pos),
+                                                       QPointF(window.mapToGlobal(pos)),
+                                                       Qt::NoButton,
+                                                       Qt::NoButton,
+                                                       Qt::NoModifier));
+    }
+    return events;
+}
+
+// Sends a mouse event of the left button straight to the event filter.
+bool sendMouseEvent(TestHelper &helper,
+                    QWindow &window,
+                    const QEvent::Type type,
+                    const QPoint &globalPos)
+{
+    const bool isMove = (type == QEvent::MouseMove);
+    const bool isRelease = (type == QEvent::MouseButtonRelease);
+    QMouseEvent event(type,
+                      QPointF(window.mapFromGlobal(globalPos)),
+                      QPointF(globalPos),
+                      isMove ? Qt::NoButton : Qt::LeftButton,
+                      isRelease ? Qt::NoButton : Qt::LeftButton,
+                      Qt::NoModifier);
+    return helper.eventFilter(&window, &event);
+}
+
+void sendUpdateRequest(TestHelper &helper, QWindow &window)
+{
+    QEvent event(QEvent::UpdateRequest);
+    helper.eventFilter(&window, &event);
+}
+
+// Counts the geometry changes a window has really gone through, each resize
+// relayouts its contents.
+class GeometryEventCounter : public QObject
+{
+public:
+    int moves = 0;
+    int resizes = 0;
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override
+    {
+        Q_UNUSED(object);
+        if (event->type() == QEvent::Move) {
+            ++moves;
+        } else if (event->type() == QEvent::Resize) {
+            ++resizes;
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+class tst_FramelessHelper : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void mouseMoveDoesNotAllocate();
+    void mouseMoveBenchmark_data();
+    void mouseMoveBenchmark();
+    void windowEventBenchmark_data();
+    void windowEventBenchmark();
+    void touchDragCallsPlatformOnce();
+    void manualMoveFollowsMouse();
+    void manualResizeFollowsMouse();
+    void manualGestureBenchmark_data();
+    void manualGestureBenchmark();
+    void snapsAlongCursorPath();
+    void consumesHandledEvents();
+    void consumeBenchmark_data();
+    void consumeBenchmark();
+    void declinedCallbackKeepsRegions();
+    void ignoresEverySubpath();
+    void metricsFollowScaleFactor();
+    void windowSoak();
+    void windowDeletedBySlot();
+    void restoresApplicationCursor();
+};
+
+void tst_FramelessHelper::mouseMoveDoesNotAllocate()
+{
+    if (!AllocationCounter::isSupported()) {
+        QSKIP("The allocations can only be counted with glibc.");
+    }
+    QWindow window;
+    window.resize(400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    // More points than the hit test memo holds, so the classification runs
+    // too, not only the memo.
+    const MouseEvents events = getTitleBarMoves(window, 64);
+    // The first one sets the hovered region.
+    for (auto &&event : events) {
+        helper.eventFilter(&window, event.get());
+    }
+    const quint64 allocations = AllocationCounter::allocations();
+    for (int i = 0; i != 100; ++i) {
+        for (auto &&event : events) {
+            helper.eventFilter(&window, event.get());
+        }
+    }
+    QCOMPARE(AllocationCounter::allocations() - allocations, quint64(0));
+}
+
+void tst_FramelessHelper::mouseMoveBenchmark_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::newRow("1 window") << 1;
+    QTest::newRow("100 windows") << 100;
+    QTest::newRow("10000 windows") << 10000;
+}
+
+void tst_FramelessHelper::mouseMoveBenchmark()
+{
+    QFETCH(int, windowCount);
+    QWindow window;
+    window.resize(400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    // The other windows only need to be known to the helper.
+    std::vector<std::unique_ptr<QWindow>> windows;
+    for (int i = 1; i < windowCount; ++i) {
+        windows.push_back(std::make_unique<QWindow>());
+        helper.setResizable(windows.back().get(), true);
+    }
+    const MouseEvents events = getTitleBarMoves(window, 64);
+    QBENCHMARK {
+        for (auto &&event : events) {
+            helper.eventFilter(&window, event.get());
+        }
+    }
+}
+
+void tst_FramelessHelper::windowEventBenchmark_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("pending");
+    QTest::newRow("UpdateRequest") << int(QEvent::UpdateRequest) << false;
+    QTest::newRow("UpdateRequest, manual update pending") << int(QEvent::UpdateRequest) << true;
+    QTest::newRow("Expose") << int(QEvent::Expose) << false;
+    QTest::newRow("Expose, manual update pending") << int(QEvent::Expose) << true;
+}
+
+// Every window gets these all the time, whether we care or not. "pending"
+// makes another window wait for its next frame, so the update requests of
+// this one get past the event table.
+void tst_FramelessHelper::windowEventBenchmark()
+{
+    QFETCH(int, type);
+    QFETCH(bool, pending);
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    QWindow other;
+    other.setGeometry(600, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.removeWindowFrame(&other);
+    window.show();
+    other.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QVERIFY(QTest::qWaitForWindowExposed(&other));
+    const QPoint press = other.position() + QPoint(200, 15);
+    if (pending) {
+        sendMouseEvent(helper, other, QEvent::MouseButtonPress, press);
+        sendMouseEvent(helper, other, QEvent::MouseMove, press + QPoint(50, 0));
+        sendMouseEvent(helper, other, QEvent::MouseMove, press + QPoint(60, 0));
+    }
+    std::unique_ptr<QEvent> event = nullptr;
+    if (type == QEvent::Expose) {
+        event = std::make_unique<QExposeEvent>(QRegion(0, 0, 400, 300));
+    } else {
+        event = std::make_unique<QEvent>(QEvent::Type(type));
+    }
+    QBENCHMARK {
+        for (int i = 0; i != 1000; ++i) {
+            helper.eventFilter(&window, event.get());
+        }
+    }
+    // Nothing has been applied to the other window in the meantime.
+    QCOMPARE(helper.getManualGeometryUpdates(), quint64(0));
+    if (pending) {
+        sendMouseEvent(helper, other, QEvent::MouseButtonRelease, press + QPoint(60, 0));
+        QCOMPARE(helper.getManualGeometryUpdates(), quint64(1));
+    }
+}
+
+void tst_FramelessHelper::touchDragCallsPlatformOnce()
+{
+    // Only the touch events themselves, not the mouse events Qt would
+    // synthesize from them.
+    QCoreApplication::setAttribute(Qt::AA_SynthesizeMouseForUnhandledTouchEvents, false);
+    QWindow window;
+    window.resize(400, 300);
+    FramelessHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    static const auto device = QTest::createTouchDevice();
+    const auto getPlatformCalls = [&helper]() -> quint64 {
+        // Every system move or resize request either starts a gesture or
+        // aborts it.
+        return helper.getStartedGestures() + helper.getAbortedGestures();
+    };
+    // Two seconds of a 120 Hz touch screen, along the title bar.
+    QTest::touchEvent(&window, device).press(0, {100, 15}, &window);
+    for (int i = 1; i != 240; ++i) {
+        QTest::touchEvent(&window, device).move(0, {100 + i, 15}, &window);
+    }
+    QTest::touchEvent(&window, device).release(0, {340, 15}, &window);
+    QCOMPARE(getPlatformCalls(), quint64(1));
+    // A tap, and a drag in the client area.
+    QTest::touchEvent(&window, device).press(0, {100, 15}, &window);
+    QTest::touchEvent(&window, device).release(0, {100, 15}, &window);
+    QTest::touchEvent(&window, device).press(0, {100, 150}, &window);
+    for (int i = 1; i != 100; ++i) {
+        QTest::touchEvent(&window, device).move(0, {100 + i, 150}, &window);
+    }
+    QTest::touchEvent(&window, device).release(0, {200, 150}, &window);
+    QCOMPARE(getPlatformCalls(), quint64(1));
+    QCoreApplication::setAttribute(Qt::AA_SynthesizeMouseForUnhandledTouchEvents, true);
+}
+
+// The offscreen platform can't move or resize windows, so these go through
+// our own implementation.
+void tst_FramelessHelper::manualMoveFollowsMouse()
+{
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QPoint origin = window.position();
+    const QPoint press = origin + QPoint(200, 15);
+    QVERIFY(!sendMouseEvent(helper, window, QEvent::MouseButtonPress, press));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Pressed);
+    // Past the drag distance.
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(50, 0));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Dragging);
+    QCOMPARE(helper.getManualGeometryUpdates(), quint64(0));
+    // Folded into a single geometry change per frame.
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(60, 10));
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(70, 20));
+    QCOMPARE(helper.getCoalescedManualMoves(), quint64(1));
+    QCOMPARE(window.position(), origin);
+    sendUpdateRequest(helper, window);
+    QCOMPARE(helper.getManualGeometryUpdates(), quint64(1));
+    QCOMPARE(window.position(), origin + QPoint(70, 20));
+    // Nothing left to apply.
+    sendUpdateRequest(helper, window);
+    QCOMPARE(helper.getManualGeometryUpdates(), quint64(1));
+    // The release applies the last position right away.
+    sendMouseEvent(helper, window, QEvent::MouseButtonRelease, press + QPoint(80, 20));
+    QCOMPARE(helper.getManualGeometryUpdates(), quint64(2));
+    QCOMPARE(window.position(), origin + QPoint(80, 20));
+    QCOMPARE(window.size(), QSize(400, 300));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Idle);
+    QCOMPARE(helper.getStartedGestures(), quint64(1));
+}
+
+void tst_FramelessHelper::manualResizeFollowsMouse()
+{
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    window.setMinimumSize({200, 150});
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QRect geometry = window.geometry();
+    // On the bottom right corner.
+    const QPoint press = geometry.topLeft() + QPoint(398, 298);
+    sendMouseEvent(helper, window, QEvent::MouseButtonPress, press);
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(50, 30));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Resizing);
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(50, 30));
+    sendUpdateRequest(helper, window);
+    QCOMPARE(window.geometry(), geometry.adjusted(0, 0, 50, 30));
+    // Not below the minimum size.
+    sendMouseEvent(helper, window, QEvent::MouseButtonRelease, press - QPoint(300, 300));
+    QCOMPARE(window.geometry().topLeft(), geometry.topLeft());
+    QCOMPARE(window.size(), QSize(200, 150));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Idle);
+}
+
+// One frame: a few mouse moves and the geometry change they lead to.
+void tst_FramelessHelper::manualGestureBenchmark_data()
+{
+    QTest::addColumn<QPoint>("pressPosition");
+    QTest::newRow("move") << QPoint(200, 15);
+    QTest::newRow("resize") << QPoint(396, 150);
+}
+
+// Four mouse moves per frame. Also reports how many geometry changes per
+// second that makes, and how many of them relayouted the window.
+void tst_FramelessHelper::manualGestureBenchmark()
+{
+    QFETCH(QPoint, pressPosition);
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    GeometryEventCounter counter;
+    window.installEventFilter(&counter);
+    const QPoint press = window.position() + pressPosition;
+    sendMouseEvent(helper, window, QEvent::MouseButtonPress, press);
+    sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(50, 0));
+    int offset = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        offset = (offset + 1) % 100;
+        for (int i = 0; i != 4; ++i) {
+            sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(offset, i));
+        }
+        sendUpdateRequest(helper, window);
+    }
+    const qint64 elapsed = qMax(timer.elapsed(), qint64(1));
+    sendMouseEvent(helper, window, QEvent::MouseButtonRelease, press);
+    // The platform reports the new geometry asynchronously.
+    QCoreApplication::processEvents();
+    const quint64 updates = helper.getManualGeometryUpdates();
+    QVERIFY(updates > 0);
+    qInfo("%llu geometry changes, %.0f per second, %d moves and %d relayouts",
+          updates,
+          updates * 1000.0 / elapsed,
+          counter.moves,
+          counter.resizes);
+    QVERIFY(quint64(counter.resizes) <= updates);
+}
+
+void tst_FramelessHelper::snapsAlongCursorPath()
+{
+    const QRect available = QGuiApplication::primaryScreen()->availableGeometry();
+    QWindow window;
+    window.setGeometry({available.topLeft() + QPoint(100, 100), QSize(300, 200)});
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.setSnappingEnabled(&window, true);
+    helper.setSnapDistance(16);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QPoint cursor = window.position() + QPoint(150, 15);
+    sendMouseEvent(helper, window, QEvent::MouseButtonPress, cursor);
+    // Moves the cursor in ten steps, one frame each.
+    const auto moveBy = [&helper, &window, &cursor](const int dx, const int dy) {
+        for (int i = 0; i != 10; ++i) {
+            cursor += QPoint(dx, dy) / 10;
+            sendMouseEvent(helper, window, QEvent::MouseMove, cursor);
+            sendUpdateRequest(helper, window);
+        }
+    };
+    moveBy(-40, 0);
+    QCOMPARE(window.x(), available.left() + 60);
+    // Within the snap distance of the left edge.
+    moveBy(-50, 0);
+    QCOMPARE(window.x(), available.left());
+    QCOMPARE(window.y(), available.top() + 100);
+    // Dropped with the cursor on the left edge of the screen.
+    moveBy(-150, 100);
+    sendMouseEvent(helper, window, QEvent::MouseButtonRelease, cursor);
+    QCOMPARE(window.geometry(),
+             WindowSnapper::getTileGeometry(available, WindowSnapper::Tile::LeftHalf));
+    QCOMPARE(helper.getGestureState(&window), FramelessHelper::GestureState::Idle);
+}
+
+void tst_FramelessHelper::consumesHandledEvents()
+{
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.addIgnoreRegion(&window, QRegion(300, 0, 100, 30));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    // How many of the two events of a click are consumed.
+    const auto click = [&helper, &window](const QPoint &pos) -> int {
+        const QPoint globalPos = window.position() + pos;
+        int consumed = 0;
+        for (auto &&type : {QEvent::MouseButtonPress, QEvent::MouseButtonRelease}) {
+            if (sendMouseEvent(helper, window, type, globalPos)) {
+                ++consumed;
+            }
+        }
+        return consumed;
+    };
+    // Disabled by default.
+    QCOMPARE(click({100, 15}), 0);
+    helper.setConsumeHandledEvents(&window, true);
+    QCOMPARE(click({100, 15}), 2);
+    QCOMPARE(click({2, 150}), 2);
+    // Neither the client area nor the ignored areas.
+    QCOMPARE(click({100, 150}), 0);
+    QCOMPARE(click({350, 15}), 0);
+    // Every event of a drag.
+    const QPoint press = window.position() + QPoint(100, 15);
+    QVERIFY(sendMouseEvent(helper, window, QEvent::MouseButtonPress, press));
+    QVERIFY(sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(50, 0)));
+    QVERIFY(sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(60, 0)));
+    QVERIFY(sendMouseEvent(helper, window, QEvent::MouseButtonRelease, press + QPoint(60, 0)));
+    // Moves without a button are never ours.
+    QVERIFY(!sendMouseEvent(helper, window, QEvent::MouseMove, press + QPoint(70, 0)));
+    // Double clicks only when they toggle the maximized state.
+    QVERIFY(!sendMouseEvent(helper,
+                            window,
+                            QEvent::MouseButtonDblClick,
+                            window.position() + QPoint(350, 15)));
+    QVERIFY(sendMouseEvent(helper,
+                           window,
+                           QEvent::MouseButtonDblClick,
+                           window.position() + QPoint(100, 15)));
+}
+
+void tst_FramelessHelper::consumeBenchmark_data()
+{
+    QTest::addColumn<bool>("consume");
+    QTest::newRow("delivered") << false;
+    QTest::newRow("consumed") << true;
+}
+
+// A click on the title bar, with some jitter, going through the whole event
+// delivery of Qt.
+void tst_FramelessHelper::consumeBenchmark()
+{
+    QFETCH(bool, consume);
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    FramelessHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.setConsumeHandledEvents(&window, consume);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QPoint pos = {100, 15};
+    const auto sendEvent = [&window, &pos](const QEvent::Type type, const int offset) {
+        const QPoint localPos = pos + QPoint(offset, 0);
+        const bool isMove = (type == QEvent::MouseMove);
+        const bool isRelease = (type == QEvent::MouseButtonRelease);
+        QMouseEvent event(type,
+                          QPointF(localPos),
+                          QPointF(window.mapToGlobal(localPos)),
+                          isMove ? Qt::NoButton : Qt::LeftButton,
+                          isRelease ? Qt::NoButton : Qt::LeftButton,
+                          Qt::NoModifier);
+        QCoreApplication::sendEvent(&window, &event);
+    };
+    QBENCHMARK {
+        sendEvent(QEvent::MouseButtonPress, 0);
+        // Below the drag distance, so the window stays where it is.
+        for (int i = 0; i != 8; ++i) {
+            sendEvent(QEvent::MouseMove, i % 3);
+        }
+        sendEvent(QEvent::MouseButtonRelease, 0);
+    }
+    QCOMPARE(helper.getStartedGestures(), quint64(0));
+}
+
+// A callback may write the region and still return false, the usual hit
+// test must then run as if it had never been called.
+void tst_FramelessHelper::declinedCallbackKeepsRegions()
+{
+    using Region = HitTestEngine::Region;
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.setHitTestCallback(&window, [](const QPointF &point, Region *region) {
+        *region = Region::Top;
+        return point.x() < 10;
+    });
+    const QVector<QPointF> points = {{5, 150}, {100, 15}, {100, 150}};
+    const QVector<Region> regions = {Region::Top, Region::Caption, Region::Client};
+    QCOMPARE(helper.hitTest(&window, points), regions);
+    for (int i = 0; i != points.size(); ++i) {
+        QCOMPARE(helper.hitTest(&window, points.at(i)), regions.at(i));
+    }
+}
+
+// Each subpath of an ignored path is filled on its own, with the fill rule
+// of the path, nothing in between.
+void tst_FramelessHelper::ignoresEverySubpath()
+{
+    using Region = HitTestEngine::Region;
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    path.addRect(100, 0, 20, 30);
+    path.addEllipse(QPointF(300, 15), 10, 10);
+    helper.addIgnorePath(&window, path);
+    QCOMPARE(helper.hitTest(&window, {110, 15}), Region::Client);
+    QCOMPARE(helper.hitTest(&window, {300, 15}), Region::Client);
+    QCOMPARE(helper.hitTest(&window, {200, 15}), Region::Caption);
+    QCOMPARE(helper.hitTest(&window, {300, 2}), Region::Caption);
+}
+
+// Also run with QT_SCALE_FACTOR set, see CMakeLists.txt: the metrics are
+// kept in device pixels, but the regions must stay the same in logical
+// pixels.
+void tst_FramelessHelper::metricsFollowScaleFactor()
+{
+    using Region = HitTestEngine::Region;
+    QWindow window, otherWindow;
+    window.resize(400, 300);
+    otherWindow.resize(400, 300);
+    FramelessHelper helper;
+    helper.removeWindowFrame(&window);
+    helper.removeWindowFrame(&otherWindow);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const qreal scaleFactor = qEnvironmentVariableIsSet("QT_SCALE_FACTOR")
+                                  ? qEnvironmentVariable("QT_SCALE_FACTOR").toDouble()
+                                  : 1.0;
+    QCOMPARE(window.devicePixelRatio(), scaleFactor);
+    const QVector<QPointF> points = {{8, 150},
+                                     {9, 150},
+                                     {200, 30},
+                                     {200, 31},
+                                     {200, 291.5},
+                                     {200, 292},
+                                     {392, 150},
+                                     {391.5, 150}};
+    const QVector<Region> regions = {Region::Left,
+                                     Region::Client,
+                                     Region::Caption,
+                                     Region::Client,
+                                     Region::Client,
+                                     Region::Bottom,
+                                     Region::Right,
+                                     Region::Client};
+    QCOMPARE(helper.hitTest(&window, points), regions);
+    for (int i = 0; i != points.size(); ++i) {
+        QCOMPARE(helper.hitTest(&window, points.at(i)), regions.at(i));
+    }
+    // The metrics of one window.
+    helper.setBorderWidth(&window, 4);
+    helper.setTitleBarHeight(&window, 40);
+    QCOMPARE(helper.hitTest(&window, {4, 150}), Region::Left);
+    QCOMPARE(helper.hitTest(&window, {5, 150}), Region::Client);
+    QCOMPARE(helper.hitTest(&window, {200, 40}), Region::Caption);
+    QCOMPARE(helper.hitTest(&otherWindow, {8, 150}), Region::Left);
+    QCOMPARE(helper.hitTest(&otherWindow, {200, 40}), Region::Client);
+}
+
+// Every window leaves a record, connections and title bar areas behind in
+// the helper, all of them must go away with the window.
+void tst_FramelessHelper::windowSoak()
+{
+    if (!AllocationCounter::isSupported()) {
+        QSKIP("The allocations can only be counted with glibc.");
+    }
+    FramelessHelper helper;
+    const auto createWindows = [&helper](const int count) {
+        for (int i = 0; i != count; ++i) {
+            QWindow window;
+            helper.setBorderWidth(&window, 4);
+            helper.addIgnoreRegion(&window, QRegion(0, 0, 50, 30));
+        }
+        QCoreApplication::processEvents();
+    };
+    // Lets Qt and the helper reach their steady state first.
+    createWindows(1000);
+    const qint64 liveAllocations = AllocationCounter::liveAllocations();
+    createWindows(100000);
+    const qint64 growth = AllocationCounter::liveAllocations() - liveAllocations;
+    QVERIFY2(growth < 100,
+             qPrintable(QStringLiteral("%1 allocations left behind.").arg(growth)));
+}
+
+// The handlers of our signals may delete the window, the event filter must
+// not touch it (or its state) anymore afterwards.
+void tst_FramelessHelper::windowDeletedBySlot()
+{
+    TestHelper helper;
+    const auto createWindow = [&helper]() -> QWindow * {
+        const auto window = new QWindow;
+        window->setGeometry(100, 100, 400, 300);
+        helper.removeWindowFrame(window);
+        window->show();
+        return window;
+    };
+    QPointer<QWindow> window = createWindow();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+    QMetaObject::Connection connection = connect(&helper,
+                                                 &FramelessHelper::captionPressed,
+                                                 this,
+                                                 [](QWindow *pressed) { delete pressed; });
+    QVERIFY(!sendMouseEvent(helper,
+                            *window,
+                            QEvent::MouseButtonPress,
+                            window->position() + QPoint(200, 15)));
+    QVERIFY(!window);
+    disconnect(connection);
+    window = createWindow();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+    connection = connect(&helper,
+                         &FramelessHelper::regionHovered,
+                         this,
+                         [](QWindow *hovered) { delete hovered; });
+    sendMouseEvent(helper, *window, QEvent::MouseMove, window->position() + QPoint(200, 15));
+    QVERIFY(!window);
+    disconnect(connection);
+    // The helper still works for the other windows.
+    window = createWindow();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+    QCOMPARE(helper.hitTest(window, {200, 15}), HitTestEngine::Region::Caption);
+    delete window;
+}
+
+void tst_FramelessHelper::restoresApplicationCursor()
+{
+    QWindow window;
+    window.setGeometry(100, 100, 400, 300);
+    TestHelper helper;
+    helper.removeWindowFrame(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const auto hover = [&helper, &window](const QPoint &pos) {
+        sendMouseEvent(helper, window, QEvent::MouseMove, window.position() + pos);
+    };
+    window.setCursor(Qt::PointingHandCursor);
+    hover({2, 150});
+    QCOMPARE(window.cursor().shape(), Qt::SizeHorCursor);
+    hover({200, 150});
+    QCOMPARE(window.cursor().shape(), Qt::PointingHandCursor);
+    // Also when it has been changed in the meantime.
+    window.setCursor(Qt::IBeamCursor);
+    hover({398, 150});
+    QCOMPARE(window.cursor().shape(), Qt::SizeHorCursor);
+    hover({200, 150});
+    QCOMPARE(window.cursor().shape(), Qt::IBeamCursor);
+    // Without one of its own, the window gets the default one back.
+    window.unsetCursor();
+    hover({2, 150});
+    hover({200, 150});
+    QCOMPARE(window.cursor().shape(), Qt::ArrowCursor);
+    QCOMPARE(helper.getAppliedCursorUpdates(), quint64(6));
+}
+
+FRAMELESSHELPER_GUI_TEST_MAIN(tst_FramelessHelper)
+
+#include "tst_framelesshelper.moc"
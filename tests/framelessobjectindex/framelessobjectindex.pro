@@ -0,0 +1,5 @@
+TARGET = tst_framelessobjectindex
+QT += widgets
+qtHaveModule(quick): QT += quick
+include(../common.pri)
+SOURCES += tst_framelessobjectindex.cpp
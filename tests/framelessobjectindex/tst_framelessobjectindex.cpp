@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "framelessobjectindex.h"
+#include "guitestmain.h"
+#include <QWidget>
+#include <memory>
+#ifdef QT_QUICK_LIB
+#include <QQuickItem>
+#endif
+
+#ifdef QT_QUICK_LIB
+namespace {
+
+// Every item sits 1 pixel right and below its parent.
+QQuickItem *createItemChain(QQuickItem *root, const int depth)
+{
+    QQuickItem *item = root;
+    for (int i = 0; i != depth; ++i) {
+        item = new QQuickItem(item);
+        item->setPosition({1.0, 1.0});
+        item->setSize({10.0, 10.0});
+    }
+    return item;
+}
+
+} // namespace
+#endif
+
+class tst_FramelessObjectIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void geometryBenchmark_data();
+    void geometryBenchmark();
+
+private:
+    using ObjectType = FramelessObjectIndex::ObjectType;
+};
+
+void tst_FramelessObjectIndex::geometryBenchmark_data()
+{
+    QTest::addColumn<bool>("quick");
+    QTest::addColumn<bool>("typed");
+    QTest::addColumn<int>("depth");
+    for (auto &&depth : {8, 64}) {
+        QTest::addRow("widget, typed, depth %d", depth) << false << true << depth;
+        QTest::addRow("widget, reflection, depth %d", depth) << false << false << depth;
+#ifdef QT_QUICK_LIB
+        QTest::addRow("item, typed, depth %d", depth) << true << true << depth;
+        QTest::addRow("item, reflection, depth %d", depth) << true << false << depth;
+#endif
+    }
+}
+
+// What an entry costs to refresh after one of its ancestors has moved, read
+// through the QWidget/QQuickItem API or through QObject::property(). Both
+// must find the same rectangle.
+void tst_FramelessObjectIndex::geometryBenchmark()
+{
+    QFETCH(bool, quick);
+    QFETCH(bool, typed);
+    QFETCH(int, depth);
+    std::unique_ptr<QObject> root = nullptr;
+    const QObject *leaf = nullptr;
+    ObjectType type = ObjectType::Reflection;
+    if (quick) {
+#ifdef QT_QUICK_LIB
+        const auto item = new QQuickItem;
+        root.reset(item);
+        leaf = createItemChain(item, depth);
+        type = ObjectType::QuickItem;
+#endif
+    } else {
+        const auto widget = new QWidget;
+        root.reset(widget);
+        widget->resize(400, 300);
+        // The same chain as the items.
+        QWidget *child = widget;
+        for (int i = 0; i != depth; ++i) {
+            child = new QWidget(child);
+            child->setGeometry(1, 1, 10, 10);
+        }
+        widget->show();
+        leaf = child;
+        type = ObjectType::Widget;
+    }
+    QVERIFY(leaf);
+    const QRectF expected = {qreal(depth), qreal(depth), 10.0, 10.0};
+    QCOMPARE(FramelessObjectIndex::mapObjectRectToWindow(leaf, type), expected);
+    if (!typed) {
+        type = ObjectType::Reflection;
+    }
+    QRectF rect = {};
+    QBENCHMARK {
+        rect = FramelessObjectIndex::mapObjectRectToWindow(leaf, type);
+    }
+    QCOMPARE(rect, expected);
+}
+
+FRAMELESSHELPER_GUI_TEST_MAIN(tst_FramelessObjectIndex)
+
+#include "tst_framelessobjectindex.moc"
@@ -0,0 +1,3 @@
+TARGET = tst_framelessregionindex
+include(../common.pri)
+SOURCES += tst_framelessregionindex.cpp
@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "framelessregionindex.h"
+#include <QtTest>
+
+namespace {
+
+// A title bar with rounded tabs and round buttons, all in one path.
+QPainterPath getTitleBarShape()
+{
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for (int i = 0; i != 8; ++i) {
+        path.addRoundedRect(10 + (i * 35), 4, 30, 26, 6, 6);
+    }
+    for (int i = 0; i != 4; ++i) {
+        path.addEllipse(QPointF(310 + (i * 24), 15), 10, 10);
+    }
+    return path;
+}
+
+// Every pixel center of the title bar.
+QVector<QPointF> getTitleBarPoints()
+{
+    QVector<QPointF> points;
+    points.reserve(400 * 30);
+    for (int y = 0; y != 30; ++y) {
+        for (int x = 0; x != 400; ++x) {
+            points.append({x + 0.5, y + 0.5});
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+class tst_FramelessRegionIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fillsEverySubpath();
+    void containsBenchmark_data();
+    void containsBenchmark();
+};
+
+void tst_FramelessRegionIndex::fillsEverySubpath()
+{
+    FramelessRegionIndex index;
+    QVERIFY(index.isEmpty());
+    index.addPath(getTitleBarShape());
+    QVERIFY(!index.isEmpty());
+    for (auto &&dpr : {1.0, 1.5, 2.0}) {
+        // Inside a tab, a button, between two tabs and between two buttons.
+        QVERIFY(index.contains({25, 15}, dpr));
+        QVERIFY(index.contains({334, 15}, dpr));
+        QVERIFY(!index.contains({42, 15}, dpr));
+        QVERIFY(!index.contains({322, 15}, dpr));
+        // Above the tabs and outside of the rounded corners.
+        QVERIFY(!index.contains({25, 2}, dpr));
+        QVERIFY(!index.contains({10.5, 4.5}, dpr));
+    }
+}
+
+void tst_FramelessRegionIndex::containsBenchmark_data()
+{
+    QTest::addColumn<bool>("indexed");
+    QTest::newRow("QPainterPath::contains()") << false;
+    QTest::newRow("FramelessRegionIndex::contains()") << true;
+}
+
+// The same shape and the same points, the band lookup against the exact
+// test of the path.
+void tst_FramelessRegionIndex::containsBenchmark()
+{
+    QFETCH(bool, indexed);
+    const QPainterPath path = getTitleBarShape();
+    FramelessRegionIndex index;
+    index.addPath(path);
+    const QVector<QPointF> points = getTitleBarPoints();
+    int inside = 0;
+    if (indexed) {
+        QBENCHMARK {
+            inside = 0;
+            for (auto &&point : qAsConst(points)) {
+                if (index.contains(point, 1.0)) {
+                    ++inside;
+                }
+            }
+        }
+    } else {
+        QBENCHMARK {
+            inside = 0;
+            for (auto &&point : qAsConst(points)) {
+                if (path.contains(point)) {
+                    ++inside;
+                }
+            }
+        }
+    }
+    QVERIFY(inside > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_FramelessRegionIndex)
+
+#include "tst_framelessregionindex.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_framelesswindowstore
+QT -= gui
+include(../common.pri)
+SOURCES += tst_framelesswindowstore.cpp
@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "allocationcounter.h"
+#include "framelesswindowstore.h"
+#include <QtTest>
+
+namespace {
+
+struct Record
+{
+    int value = 0;
+};
+
+// Stand-ins for the window pointers the store is keyed by.
+int m_keys[1000] = {};
+
+} // namespace
+
+class tst_FramelessWindowStore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void insertAndFind();
+    void removeRecyclesSlots();
+    void addressesAreStable();
+    void forEachVisitsLiveRecords();
+    void removeForgetsLastLookup();
+    void lookupDoesNotAllocate();
+    void lookupBenchmark();
+};
+
+void tst_FramelessWindowStore::insertAndFind()
+{
+    FramelessWindowStore<const int *, Record> store;
+    QVERIFY(store.isEmpty());
+    QVERIFY(!store.find(&m_keys[0]));
+    bool inserted = false;
+    store.findOrInsert(&m_keys[0], &inserted).value = 1;
+    QVERIFY(inserted);
+    store.findOrInsert(&m_keys[1], &inserted).value = 2;
+    QVERIFY(inserted);
+    QCOMPARE(store.findOrInsert(&m_keys[0], &inserted).value, 1);
+    QVERIFY(!inserted);
+    QCOMPARE(store.size(), 2);
+    QVERIFY(store.find(&m_keys[1]));
+    QCOMPARE(store.find(&m_keys[1])->value, 2);
+    const auto &constStore = store;
+    QCOMPARE(constStore.find(&m_keys[0])->value, 1);
+    QVERIFY(!constStore.find(&m_keys[2]));
+}
+
+void tst_FramelessWindowStore::removeRecyclesSlots()
+{
+    FramelessWindowStore<const int *, Record> store;
+    Record *first = &store.findOrInsert(&m_keys[0]);
+    first->value = 1;
+    store.findOrInsert(&m_keys[1]).value = 2;
+    store.remove(&m_keys[0]);
+    QVERIFY(!store.find(&m_keys[0]));
+    QCOMPARE(store.size(), 1);
+    // Removing twice is harmless.
+    store.remove(&m_keys[0]);
+    QCOMPARE(store.size(), 1);
+    // The freed slot is reused, and doesn't remember its previous owner.
+    bool inserted = false;
+    Record &reused = store.findOrInsert(&m_keys[2], &inserted);
+    QVERIFY(inserted);
+    QCOMPARE(&reused, first);
+    QCOMPARE(reused.value, 0);
+    QCOMPARE(store.find(&m_keys[1])->value, 2);
+}
+
+void tst_FramelessWindowStore::addressesAreStable()
+{
+    FramelessWindowStore<const int *, Record> store;
+    Record *first = &store.findOrInsert(&m_keys[0]);
+    first->value = 42;
+    for (int i = 1; i != 1000; ++i) {
+        store.findOrInsert(&m_keys[i]).value = i;
+    }
+    QCOMPARE(store.find(&m_keys[0]), first);
+    QCOMPARE(first->value, 42);
+    QCOMPARE(store.find(&m_keys[999])->value, 999);
+}
+
+void tst_FramelessWindowStore::forEachVisitsLiveRecords()
+{
+    FramelessWindowStore<const int *, Record> store;
+    for (int i = 0; i != 10; ++i) {
+        store.findOrInsert(&m_keys[i]).value = i;
+    }
+    store.remove(&m_keys[3]);
+    store.remove(&m_keys[7]);
+    int count = 0, sum = 0;
+    store.forEach([&count, &sum](const int *key, Record &record) {
+        QCOMPARE(key, &m_keys[record.value]);
+        ++count;
+        sum += record.value;
+        record.value *= 2;
+    });
+    QCOMPARE(count, 8);
+    QCOMPARE(sum, 45 - 3 - 7);
+    QCOMPARE(store.find(&m_keys[9])->value, 18);
+}
+
+void tst_FramelessWindowStore::removeForgetsLastLookup()
+{
+    FramelessWindowStore<const int *, Record> store;
+    store.findOrInsert(&m_keys[0]).value = 1;
+    // Remembered as the last lookup.
+    QVERIFY(store.find(&m_keys[0]));
+    store.remove(&m_keys[0]);
+    QVERIFY(!store.find(&m_keys[0]));
+    store.findOrInsert(&m_keys[1]).value = 2;
+    QVERIFY(!store.find(&m_keys[0]));
+    QCOMPARE(store.find(&m_keys[1])->value, 2);
+}
+
+void tst_FramelessWindowStore::lookupDoesNotAllocate()
+{
+    if (!AllocationCounter::isSupported()) {
+        QSKIP("The allocations can only be counted with glibc.");
+    }
+    FramelessWindowStore<const int *, Record> store;
+    for (int i = 0; i != 1000; ++i) {
+        store.findOrInsert(&m_keys[i]).value = i;
+    }
+    const quint64 allocations = AllocationCounter::allocations();
+    int sum = 0;
+    for (int i = 0; i != 1000; ++i) {
+        // Both the remembered and the hashed lookups.
+        sum += store.find(&m_keys[i])->value;
+        sum += store.find(&m_keys[i])->value;
+        sum += store.findOrInsert(&m_keys[999 - i]).value;
+    }
+    QCOMPARE(AllocationCounter::allocations() - allocations, quint64(0));
+    QCOMPARE(sum, 3 * 999 * 1000 / 2);
+}
+
+void tst_FramelessWindowStore::lookupBenchmark()
+{
+    FramelessWindowStore<const int *, Record> store;
+    for (int i = 0; i != 1000; ++i) {
+        store.findOrInsert(&m_keys[i]).value = i;
+    }
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i != 1000; ++i) {
+            sum += store.find(&m_keys[i])->value;
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_FramelessWindowStore)
+
+#include "tst_framelesswindowstore.moc"
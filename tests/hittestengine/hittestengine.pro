@@ -0,0 +1,4 @@
+TARGET = tst_hittestengine
+QT -= gui
+include(../common.pri)
+SOURCES += tst_hittestengine.cpp
@@ -0,0 +1,235 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "hittestengine.h"
+#include <QtTest>
+#include <vector>
+
+namespace {
+
+using Region = HitTestEngine::Region;
+
+// A 400x300 window with 8 pixels wide borders and a 30 pixels high title
+// bar, all the tests start from it.
+HitTestEngine::Metrics getMetrics()
+{
+    HitTestEngine::Metrics metrics = {};
+    metrics.windowWidth = 400;
+    metrics.windowHeight = 300;
+    metrics.borderWidth = 8;
+    metrics.borderHeight = 8;
+    metrics.titleBarHeight = 30;
+    return metrics;
+}
+
+// Points covering the whole window and a bit around it, on the borders,
+// between them and at fractional positions.
+struct Points
+{
+    std::vector<qreal> xs, ys;
+};
+
+Points getPoints(const HitTestEngine::Metrics &metrics, const qreal step)
+{
+    Points points;
+    for (qreal y = -2; y <= (metrics.windowHeight + 2); y += step) {
+        for (qreal x = -2; x <= (metrics.windowWidth + 2); x += step) {
+            points.xs.push_back(x);
+            points.ys.push_back(y);
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+class tst_HitTestEngine : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void classifiesEdges();
+    void widensCorners();
+    void maximizedHasNoEdges();
+    void fixedSizeHasFixedBorders();
+    void honorsResizeEdges();
+    void mapsRegions();
+    void batchMatchesScalar();
+    void batchHandlesAnyCount();
+    void scalarBenchmark();
+    void batchBenchmark();
+};
+
+void tst_HitTestEngine::classifiesEdges()
+{
+    const HitTestEngine::Metrics metrics = getMetrics();
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 150), Region::Client);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 20), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 30), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 30.5), Region::Client);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 0), Region::Top);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 8), Region::Top);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 300), Region::Bottom);
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 150), Region::Left);
+    QCOMPARE(HitTestEngine::classify(metrics, 400, 150), Region::Right);
+    QCOMPARE(HitTestEngine::classify(metrics, 395, 3), Region::TopRight);
+    QCOMPARE(HitTestEngine::classify(metrics, 3, 297), Region::BottomLeft);
+    QCOMPARE(HitTestEngine::classify(metrics, 397, 297), Region::BottomRight);
+    // The title bar is still a resize edge on the sides.
+    QCOMPARE(HitTestEngine::classify(metrics, 4, 20), Region::Left);
+}
+
+void tst_HitTestEngine::widensCorners()
+{
+    const HitTestEngine::Metrics metrics = getMetrics();
+    // Twice the border width along the top and bottom edges...
+    QCOMPARE(HitTestEngine::classify(metrics, 12, 4), Region::TopLeft);
+    QCOMPARE(HitTestEngine::classify(metrics, 388, 296), Region::BottomRight);
+    QCOMPARE(HitTestEngine::classify(metrics, 20, 4), Region::Top);
+    // ... but not elsewhere.
+    QCOMPARE(HitTestEngine::classify(metrics, 12, 150), Region::Client);
+}
+
+void tst_HitTestEngine::maximizedHasNoEdges()
+{
+    HitTestEngine::Metrics metrics = getMetrics();
+    metrics.maximized = true;
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 0), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 150), Region::Client);
+    QCOMPARE(HitTestEngine::classify(metrics, 400, 300), Region::Client);
+}
+
+void tst_HitTestEngine::fixedSizeHasFixedBorders()
+{
+    HitTestEngine::Metrics metrics = getMetrics();
+    metrics.fixedSize = true;
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 150), Region::FixedBorder);
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 0), Region::FixedBorder);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 20), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 150), Region::Client);
+}
+
+void tst_HitTestEngine::honorsResizeEdges()
+{
+    HitTestEngine::Metrics metrics = getMetrics();
+    metrics.resizeEdges = Qt::BottomEdge | Qt::RightEdge;
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 150), Region::Client);
+    QCOMPARE(HitTestEngine::classify(metrics, 200, 0), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 0), Region::Caption);
+    QCOMPARE(HitTestEngine::classify(metrics, 400, 0), Region::Right);
+    QCOMPARE(HitTestEngine::classify(metrics, 0, 300), Region::Bottom);
+    QCOMPARE(HitTestEngine::classify(metrics, 400, 300), Region::BottomRight);
+}
+
+void tst_HitTestEngine::mapsRegions()
+{
+    QVERIFY(!HitTestEngine::toEdges(Region::Client));
+    QVERIFY(!HitTestEngine::toEdges(Region::Caption));
+    QVERIFY(!HitTestEngine::toEdges(Region::FixedBorder));
+    QCOMPARE(HitTestEngine::toEdges(Region::TopLeft), Qt::TopEdge | Qt::LeftEdge);
+    QCOMPARE(HitTestEngine::toEdges(Region::BottomRight), Qt::BottomEdge | Qt::RightEdge);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::Client), Qt::ArrowCursor);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::FixedBorder), Qt::ArrowCursor);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::Left), Qt::SizeHorCursor);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::Bottom), Qt::SizeVerCursor);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::TopLeft), Qt::SizeFDiagCursor);
+    QCOMPARE(HitTestEngine::toCursorShape(Region::TopRight), Qt::SizeBDiagCursor);
+}
+
+void tst_HitTestEngine::batchMatchesScalar()
+{
+    std::vector<HitTestEngine::Metrics> allMetrics(6, getMetrics());
+    allMetrics[1].maximized = true;
+    allMetrics[2].fixedSize = true;
+    allMetrics[3].resizeEdges = Qt::BottomEdge | Qt::RightEdge;
+    allMetrics[4].resizeEdges = {};
+    allMetrics[5].borderWidth = 0;
+    allMetrics[5].borderHeight = 0;
+    allMetrics[5].titleBarHeight = 0;
+    for (auto &&metrics : qAsConst(allMetrics)) {
+        const Points points = getPoints(metrics, 0.25);
+        const int count = static_cast<int>(points.xs.size());
+        std::vector<Region> regions(count);
+        HitTestEngine::classify(metrics, points.xs.data(), points.ys.data(), regions.data(), count);
+        for (int i = 0; i != count; ++i) {
+            QCOMPARE(regions[i], HitTestEngine::classify(metrics, points.xs[i], points.ys[i]));
+        }
+    }
+}
+
+void tst_HitTestEngine::batchHandlesAnyCount()
+{
+    const HitTestEngine::Metrics metrics = getMetrics();
+    const qreal xs[] = {0, 200, 400, 200, 12};
+    const qreal ys[] = {150, 20, 150, 150, 4};
+    const Region expected[] = {Region::Left,
+                               Region::Caption,
+                               Region::Right,
+                               Region::Client,
+                               Region::TopLeft};
+    // Every length, so the vector kernels and the scalar tail both run.
+    for (int count = 0; count <= 5; ++count) {
+        Region regions[6] = {};
+        regions[count] = Region::FixedBorder;
+        HitTestEngine::classify(metrics, xs, ys, regions, count);
+        for (int i = 0; i != count; ++i) {
+            QCOMPARE(regions[i], expected[i]);
+        }
+        // Nothing is written past the end.
+        QCOMPARE(regions[count], Region::FixedBorder);
+    }
+}
+
+// Both benchmarks classify the same million points, divide it by the time
+// per iteration to get the points per second.
+void tst_HitTestEngine::scalarBenchmark()
+{
+    const HitTestEngine::Metrics metrics = getMetrics();
+    const Points points = getPoints(metrics, 0.35);
+    const int count = static_cast<int>(points.xs.size());
+    std::vector<Region> regions(count);
+    QBENCHMARK {
+        for (int i = 0; i != count; ++i) {
+            regions[i] = HitTestEngine::classify(metrics, points.xs[i], points.ys[i]);
+        }
+    }
+    QCOMPARE(regions.front(), Region::TopLeft);
+}
+
+void tst_HitTestEngine::batchBenchmark()
+{
+    const HitTestEngine::Metrics metrics = getMetrics();
+    const Points points = getPoints(metrics, 0.35);
+    const int count = static_cast<int>(points.xs.size());
+    std::vector<Region> regions(count);
+    QBENCHMARK {
+        HitTestEngine::classify(metrics, points.xs.data(), points.ys.data(), regions.data(), count);
+    }
+    QCOMPARE(regions.front(), Region::TopLeft);
+}
+
+QTEST_APPLESS_MAIN(tst_HitTestEngine)
+
+#include "tst_hittestengine.moc"
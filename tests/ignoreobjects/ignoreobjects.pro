@@ -0,0 +1,4 @@
+TARGET = tst_ignoreobjects
+QT += widgets
+include(../common.pri)
+SOURCES += tst_ignoreobjects.cpp
@@ -0,0 +1,282 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "allocationcounter.h"
+#include "framelesshelper.h"
+#include "guitestmain.h"
+#include <QWidget>
+#include <QWindow>
+
+namespace {
+
+using Region = HitTestEngine::Region;
+
+// A 400x300 top level widget, the title bar is the default 30 pixels high.
+class TopLevel : public QWidget
+{
+public:
+    explicit TopLevel()
+    {
+        resize(400, 300);
+        show();
+    }
+
+    QWidget *addChild(const QRect &geometry, QWidget *parent = nullptr)
+    {
+        const auto child = new QWidget(parent ? parent : this);
+        child->setGeometry(geometry);
+        child->show();
+        return child;
+    }
+};
+
+// "count" children of one container in the title bar, the worst case for
+// the bookkeeping of the shared ancestors.
+QObjectList addChildren(TopLevel &topLevel, const int count)
+{
+    QWidget *container = topLevel.addChild({0, 0, 400, 30});
+    QObjectList children;
+    children.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        children.append(topLevel.addChild({(i * 10) % 390, 0, 10, 30}, container));
+    }
+    return children;
+}
+
+} // namespace
+
+class tst_IgnoreObjects : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void forgetsDestroyedObjects();
+    void ignoreObjectSoak();
+    void followsNewAncestors();
+    void followsUnregisteredOverlays();
+    void addsAndRemovesInBulk();
+    void registrationBenchmark();
+    void removalBenchmark();
+    void hitTestBenchmark_data();
+    void hitTestBenchmark();
+};
+
+void tst_IgnoreObjects::forgetsDestroyedObjects()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    QWidget *button = topLevel.addChild({300, 0, 100, 30});
+    helper.addIgnoreObject(window, button);
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 1);
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Client);
+    delete button;
+    QVERIFY(helper.getIgnoreObjects(window).isEmpty());
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Caption);
+    // Also when it goes away with one of its ancestors.
+    QWidget *container = topLevel.addChild({0, 0, 400, 30});
+    helper.addIgnoreObject(window, topLevel.addChild({300, 0, 100, 30}, container));
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Client);
+    delete container;
+    QVERIFY(helper.getIgnoreObjects(window).isEmpty());
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Caption);
+}
+
+// The index entries, the watched ancestors and the grid cells of the
+// objects must all be released when they are destroyed.
+void tst_IgnoreObjects::ignoreObjectSoak()
+{
+    if (!AllocationCounter::isSupported()) {
+        QSKIP("The allocations can only be counted with glibc.");
+    }
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    // Always registered, so the index itself stays alive.
+    helper.addIgnoreObject(window, topLevel.addChild({0, 0, 30, 30}));
+    const auto createObjects = [&helper, &topLevel, window](const int count) {
+        for (int i = 0; i != count; ++i) {
+            QWidget *object = topLevel.addChild({50 + (i % 300), 0, 50, 30});
+            helper.addIgnoreObject(window, object);
+            // Brings the index up to date.
+            QCOMPARE(helper.hitTest(window, {75.0 + (i % 300), 15}), Region::Client);
+            delete object;
+        }
+        QCoreApplication::processEvents();
+    };
+    createObjects(1000);
+    const qint64 liveAllocations = AllocationCounter::liveAllocations();
+    createObjects(100000);
+    const qint64 growth = AllocationCounter::liveAllocations() - liveAllocations;
+    QVERIFY2(growth < 100,
+             qPrintable(QStringLiteral("%1 allocations left behind.").arg(growth)));
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 1);
+}
+
+void tst_IgnoreObjects::followsNewAncestors()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    QWidget *oldContainer = topLevel.addChild({0, 0, 200, 30});
+    QWidget *newContainer = topLevel.addChild({200, 0, 200, 30});
+    QWidget *button = topLevel.addChild({0, 0, 50, 30}, oldContainer);
+    helper.addIgnoreObject(window, button);
+    QCOMPARE(helper.hitTest(window, {25, 15}), Region::Client);
+    button->setParent(newContainer);
+    button->show();
+    QCOMPARE(helper.hitTest(window, {225, 15}), Region::Client);
+    QCOMPARE(helper.hitTest(window, {25, 15}), Region::Caption);
+    newContainer->move(250, 0);
+    QCOMPARE(helper.hitTest(window, {275, 15}), Region::Client);
+    QCOMPARE(helper.hitTest(window, {225, 15}), Region::Caption);
+    // The old container doesn't matter anymore: moving it keeps the hit
+    // test results.
+    const quint64 hits = helper.getHitTestCacheHits();
+    oldContainer->move(0, 100);
+    QCOMPARE(helper.hitTest(window, {275, 15}), Region::Client);
+    QCOMPARE(helper.getHitTestCacheHits(), hits + 1);
+    delete oldContainer;
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 1);
+}
+
+// Covering an ignored object with a widget nobody registered must be seen
+// right away by the z-order aware hit test, at the same point.
+void tst_IgnoreObjects::followsUnregisteredOverlays()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    helper.setZOrderHitTestEnabled(window, true);
+    helper.addIgnoreObject(window, topLevel.addChild({300, 0, 100, 30}));
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Client);
+    QWidget *overlay = topLevel.addChild({300, 0, 100, 30});
+    overlay->raise();
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Caption);
+    overlay->hide();
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Client);
+    overlay->show();
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Caption);
+    delete overlay;
+    QCOMPARE(helper.hitTest(window, {350, 15}), Region::Client);
+}
+
+void tst_IgnoreObjects::addsAndRemovesInBulk()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    const QObjectList children = addChildren(topLevel, 3);
+    helper.addIgnoreObjects(window, children);
+    // Already there.
+    helper.addIgnoreObjects(window, children);
+    helper.addIgnoreObject(window, children.at(1));
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 3);
+    QCOMPARE(helper.hitTest(window, {15, 15}), Region::Client);
+    helper.removeIgnoreObject(window, children.at(1));
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 2);
+    QVERIFY(!helper.getIgnoreObjects(window).contains(children.at(1)));
+    QCOMPARE(helper.hitTest(window, {15, 15}), Region::Caption);
+    QCOMPARE(helper.hitTest(window, {25, 15}), Region::Client);
+    // Not there anymore.
+    helper.removeIgnoreObject(window, children.at(1));
+    QCOMPARE(helper.getIgnoreObjects(window).size(), 2);
+    helper.clearIgnoreObjects(window);
+    QVERIFY(helper.getIgnoreObjects(window).isEmpty());
+    QCOMPARE(helper.hitTest(window, {25, 15}), Region::Caption);
+}
+
+void tst_IgnoreObjects::registrationBenchmark()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    const QObjectList children = addChildren(topLevel, 10000);
+    QBENCHMARK {
+        helper.addIgnoreObjects(window, children);
+        helper.clearIgnoreObjects(window);
+    }
+}
+
+void tst_IgnoreObjects::removalBenchmark()
+{
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    const QObjectList children = addChildren(topLevel, 10000);
+    QBENCHMARK {
+        helper.addIgnoreObjects(window, children);
+        for (auto &&child : qAsConst(children)) {
+            helper.removeIgnoreObject(window, child);
+        }
+    }
+    QVERIFY(helper.getIgnoreObjects(window).isEmpty());
+}
+
+void tst_IgnoreObjects::hitTestBenchmark_data()
+{
+    QTest::addColumn<int>("objectCount");
+    QTest::newRow("1 object") << 1;
+    QTest::newRow("10 objects") << 10;
+    QTest::newRow("100 objects") << 100;
+    QTest::newRow("1000 objects") << 1000;
+    QTest::newRow("10000 objects") << 10000;
+}
+
+// One pass over the title bar between the two resize edges, a different
+// point every time so the memo in front of the index never helps.
+void tst_IgnoreObjects::hitTestBenchmark()
+{
+    QFETCH(int, objectCount);
+    TopLevel topLevel;
+    QVERIFY(QTest::qWaitForWindowExposed(&topLevel));
+    QWindow *window = topLevel.windowHandle();
+    FramelessHelper helper;
+    helper.addIgnoreObjects(window, addChildren(topLevel, objectCount));
+    // Brings the index up to date.
+    QCOMPARE(helper.hitTest(window, {5, 15}), Region::Client);
+    int ignored = 0;
+    QBENCHMARK {
+        ignored = 0;
+        for (int x = 8; x != 392; ++x) {
+            if (helper.hitTest(window, {x + 0.5, 15}) == Region::Client) {
+                ++ignored;
+            }
+        }
+    }
+    // The children cover [0, 390) at most.
+    QCOMPARE(ignored, qMin(objectCount * 10, 390) - 8);
+}
+
+FRAMELESSHELPER_GUI_TEST_MAIN(tst_IgnoreObjects)
+
+#include "tst_ignoreobjects.moc"
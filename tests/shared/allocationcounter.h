@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QtCore/qglobal.h>
+#include <atomic>
+#include <cstdlib>
+
+// Counts the heap allocations of the whole test executable, including the
+// ones of Qt and of the standard library, by replacing malloc() and friends.
+// Only possible with glibc, which exports its own implementation under
+// another name. Replaces global functions: include it in exactly one
+// translation unit.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define FRAMELESSHELPER_HAS_ALLOCATION_COUNTER
+#endif
+
+class AllocationCounter
+{
+public:
+    static constexpr bool isSupported()
+    {
+#ifdef FRAMELESSHELPER_HAS_ALLOCATION_COUNTER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Since the start of the process. A reallocation counts as an
+    // allocation, since it may well be one.
+    static quint64 allocations() { return m_allocations.load(std::memory_order_relaxed); }
+    // Allocated and not freed yet.
+    static qint64 liveAllocations()
+    {
+        return static_cast<qint64>(allocations() - m_frees.load(std::memory_order_relaxed));
+    }
+
+    static void countAllocation() { m_allocations.fetch_add(1, std::memory_order_relaxed); }
+    static void countFree() { m_frees.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<quint64> m_allocations = {0};
+    static inline std::atomic<quint64> m_frees = {0};
+};
+
+#ifdef FRAMELESSHELPER_HAS_ALLOCATION_COUNTER
+#include <cerrno>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size)
+{
+    AllocationCounter::countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    AllocationCounter::countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    void *ret = __libc_realloc(pointer, size);
+    if (pointer) {
+        AllocationCounter::countFree();
+    }
+    if (ret) {
+        AllocationCounter::countAllocation();
+    }
+    return ret;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    AllocationCounter::countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    void *ret = memalign(alignment, size);
+    if (!ret) {
+        return ENOMEM;
+    }
+    *pointer = ret;
+    return 0;
+}
+
+void free(void *pointer)
+{
+    if (pointer) {
+        AllocationCounter::countFree();
+    }
+    __libc_free(pointer);
+}
+}
+#endif
@@ -0,0 +1,50 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QtCore/qglobal.h>
+#include <QtTest>
+#ifdef QT_WIDGETS_LIB
+#include <QApplication>
+#define FRAMELESSHELPER_TEST_APPLICATION QApplication
+#else
+#include <QGuiApplication>
+#define FRAMELESSHELPER_TEST_APPLICATION QGuiApplication
+#endif
+
+// Like QTEST_MAIN(), but runs on the offscreen platform unless told
+// otherwise: nothing in here needs a display. The tests using widgets get a
+// QApplication.
+#define FRAMELESSHELPER_GUI_TEST_MAIN(TestObject) \
+    int main(int argc, char *argv[]) \
+    { \
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) { \
+            qputenv("QT_QPA_PLATFORM", "offscreen"); \
+        } \
+        FRAMELESSHELPER_TEST_APPLICATION application(argc, argv); \
+        TestObject test; \
+        return QTest::qExec(&test, argc, argv); \
+    }
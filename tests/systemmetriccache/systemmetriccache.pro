@@ -0,0 +1,4 @@
+TARGET = tst_systemmetriccache
+QT -= gui
+include(../common.pri)
+SOURCES += tst_systemmetriccache.cpp
@@ -0,0 +1,199 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "systemmetriccache.h"
+#include <QtTest>
+
+namespace {
+
+using Metric = SystemMetricCache::Metric;
+
+// Windows at 96 DPI: 8 pixels wide borders and a 23 pixels high caption,
+// scaled to the DPI when asked for physical pixels.
+class FakeProvider : public SystemMetricCache::Provider
+{
+public:
+    int getSystemMetric(const Metric metric,
+                        const quint32 dpi,
+                        const bool dpiAware) const override
+    {
+        ++calls;
+        if (!available) {
+            return 0;
+        }
+        const int value = (metric == Metric::TitleBarHeight) ? 23 : 8;
+        return dpiAware ? qRound(value * dpi / 96.0) : value;
+    }
+
+    mutable int calls = 0;
+    bool available = true;
+};
+
+// Stand-ins for the windows.
+int m_windows[2] = {};
+
+} // namespace
+
+class tst_SystemMetricCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void systemValues();
+    void defaultValues();
+    void userValues();
+    void cachesPerDpi();
+    void invalidates();
+    void lookupBenchmark_data();
+    void lookupBenchmark();
+};
+
+void tst_SystemMetricCache::systemValues()
+{
+    FakeProvider provider;
+    SystemMetricCache cache(&provider);
+    const void *window = &m_windows[0];
+    QCOMPARE(cache.getValue(window, Metric::BorderWidth, 96, true), 8);
+    // The border above the caption is part of the title bar.
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 96, true), 31);
+    QCOMPARE(cache.getValue(window, Metric::BorderWidth, 144, true), 12);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 47);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, false), 31);
+}
+
+void tst_SystemMetricCache::defaultValues()
+{
+    FakeProvider provider;
+    provider.available = false;
+    SystemMetricCache cache(&provider);
+    const void *window = &m_windows[0];
+    QCOMPARE(cache.getValue(window, Metric::BorderHeight, 96, true), 8);
+    QCOMPARE(cache.getValue(window, Metric::BorderHeight, 192, true), 16);
+    QCOMPARE(cache.getValue(window, Metric::BorderHeight, 192, false), 8);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 192, true), 78);
+}
+
+void tst_SystemMetricCache::userValues()
+{
+    FakeProvider provider;
+    SystemMetricCache cache(&provider);
+    const void *window = &m_windows[0];
+    QCOMPARE(cache.getUserValue(window, Metric::BorderHeight), 0);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 47);
+    cache.setUserValue(window, Metric::BorderHeight, 10);
+    QCOMPARE(cache.getUserValue(window, Metric::BorderHeight), 10);
+    QCOMPARE(cache.getValue(window, Metric::BorderHeight, 144, true), 15);
+    // The system caption on top of the user border.
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 50);
+    // A user title bar height already includes the border.
+    cache.setUserValue(window, Metric::TitleBarHeight, 40);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 60);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true, true), 50);
+    // Other windows are not affected.
+    QCOMPARE(cache.getValue(&m_windows[1], Metric::TitleBarHeight, 144, true), 47);
+    cache.removeWindow(window);
+    QCOMPARE(cache.getUserValue(window, Metric::TitleBarHeight), 0);
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 47);
+}
+
+void tst_SystemMetricCache::cachesPerDpi()
+{
+    FakeProvider provider;
+    SystemMetricCache cache(&provider);
+    const void *window = &m_windows[0];
+    // The caption and the border height.
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 47);
+    QCOMPARE(provider.calls, 2);
+    QCOMPARE(cache.misses(), quint64(2));
+    for (int i = 0; i != 100; ++i) {
+        QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 144, true), 47);
+        QCOMPARE(cache.getValue(window, Metric::BorderHeight, 144, true), 12);
+    }
+    QCOMPARE(provider.calls, 2);
+    QCOMPARE(cache.hits(), quint64(200));
+    // Moved to another screen.
+    QCOMPARE(cache.getValue(window, Metric::TitleBarHeight, 96, true), 31);
+    QCOMPARE(provider.calls, 4);
+    QCOMPARE(cache.misses(), quint64(4));
+}
+
+void tst_SystemMetricCache::invalidates()
+{
+    FakeProvider provider;
+    SystemMetricCache cache(&provider);
+    for (auto &&window : m_windows) {
+        QCOMPARE(cache.getValue(&window, Metric::BorderWidth, 96, true), 8);
+    }
+    QCOMPARE(provider.calls, 2);
+    cache.invalidate(&m_windows[0]);
+    for (auto &&window : m_windows) {
+        QCOMPARE(cache.getValue(&window, Metric::BorderWidth, 96, true), 8);
+    }
+    QCOMPARE(provider.calls, 3);
+    cache.invalidate();
+    for (auto &&window : m_windows) {
+        QCOMPARE(cache.getValue(&window, Metric::BorderWidth, 96, true), 8);
+    }
+    QCOMPARE(provider.calls, 5);
+}
+
+void tst_SystemMetricCache::lookupBenchmark_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("cache hit") << true;
+    QTest::newRow("provider call") << false;
+}
+
+// A thousand title bar heights, the way every WM_NCHITTEST of a window asks
+// for them. The real provider goes through GetSystemMetricsForDpi() twice
+// for each of them, the fake one is a lower bound.
+void tst_SystemMetricCache::lookupBenchmark()
+{
+    QFETCH(bool, cached);
+    FakeProvider provider;
+    SystemMetricCache cache(&provider);
+    const void *window = &m_windows[0];
+    int value = 0;
+    if (cached) {
+        QBENCHMARK {
+            for (int i = 0; i != 1000; ++i) {
+                value = cache.getValue(window, Metric::TitleBarHeight, 144, true);
+            }
+        }
+        QCOMPARE(provider.calls, 2);
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i != 1000; ++i) {
+                value = provider.getSystemMetric(Metric::TitleBarHeight, 144, true)
+                        + provider.getSystemMetric(Metric::BorderHeight, 144, true);
+            }
+        }
+    }
+    QCOMPARE(value, 47);
+}
+
+QTEST_APPLESS_MAIN(tst_SystemMetricCache)
+
+#include "tst_systemmetriccache.moc"
@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+CONFIG -= ordered
+SUBDIRS += \
+    framelessregionindex \
+    framelesswindowstore \
+    hittestengine \
+    systemmetriccache \
+    titlebarregionmap \
+    touchgesturerecognizer \
+    windowsnapper
+qtHaveModule(widgets): SUBDIRS += framelessobjectindex
+!win32:versionAtLeast(QT_VERSION, 5.15.0) {
+    SUBDIRS += framelesshelper
+    qtHaveModule(widgets): SUBDIRS += ignoreobjects
+}
@@ -0,0 +1,4 @@
+TARGET = tst_titlebarregionmap
+QT -= gui
+include(../common.pri)
+SOURCES += tst_titlebarregionmap.cpp
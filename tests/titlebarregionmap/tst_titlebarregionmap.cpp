@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "titlebarregionmap.h"
+#include <QtTest>
+
+namespace {
+
+using Anchor = TitleBarRegionMap::Anchor;
+using Unit = TitleBarRegionMap::Unit;
+using Result = TitleBarRegionMap::Result;
+using Zone = TitleBarRegionMap::Zone;
+
+Zone getZone(const Anchor anchor,
+             const Unit unit,
+             const qreal offset,
+             const qreal width,
+             const bool draggable,
+             const qreal top = 0,
+             const qreal height = 30)
+{
+    Zone zone = {};
+    zone.anchor = anchor;
+    zone.unit = unit;
+    zone.offset = offset;
+    zone.width = width;
+    zone.top = top;
+    zone.height = height;
+    zone.draggable = draggable;
+    return zone;
+}
+
+// A typical title bar: draggable all along, except for an icon on the left
+// and the window buttons on the right.
+QVector<Zone> getTitleBarZones()
+{
+    return {getZone(Anchor::Left, Unit::Percent, 0, 100, true),
+            getZone(Anchor::Left, Unit::Pixels, 0, 30, false),
+            getZone(Anchor::Right, Unit::Pixels, 0, 120, false)};
+}
+
+} // namespace
+
+class tst_TitleBarRegionMap : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptyMap();
+    void anchorsFollowTheWidth();
+    void centeredZones();
+    void rowsAreSeparate();
+    void refinesOnlyTheTitleBar();
+};
+
+void tst_TitleBarRegionMap::emptyMap()
+{
+    TitleBarRegionMap map;
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.lookup(800, 10, 10), Result::Unspecified);
+    // Zones without an area are ignored.
+    map.setZones({getZone(Anchor::Left, Unit::Pixels, 0, 0, true),
+                  getZone(Anchor::Left, Unit::Pixels, 0, 100, true, 0, 0)});
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.zones().size(), 2);
+    QCOMPARE(map.lookup(800, 10, 0), Result::Unspecified);
+}
+
+void tst_TitleBarRegionMap::anchorsFollowTheWidth()
+{
+    const TitleBarRegionMap map(getTitleBarZones());
+    QVERIFY(!map.isEmpty());
+    QCOMPARE(map.lookup(800, 400, 15), Result::Drag);
+    QCOMPARE(map.lookup(800, 10, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(800, 750, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(800, 679, 15), Result::Drag);
+    QCOMPARE(map.lookup(800, 400, 40), Result::Unspecified);
+    // The buttons stay on the right edge of a narrower window.
+    QCOMPARE(map.lookup(400, 350, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(400, 250, 15), Result::Drag);
+    QCOMPARE(map.lookup(400, 10, 15), Result::NoDrag);
+}
+
+void tst_TitleBarRegionMap::centeredZones()
+{
+    const TitleBarRegionMap map(
+        {getZone(Anchor::Left, Unit::Percent, 0, 100, true),
+         getZone(Anchor::Center, Unit::Pixels, 0, 100, false),
+         getZone(Anchor::Center, Unit::Percent, 25, 10, false)});
+    QCOMPARE(map.lookup(800, 400, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(800, 349, 15), Result::Drag);
+    QCOMPARE(map.lookup(1000, 500, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(1000, 449, 15), Result::Drag);
+    // 25% right of the center, 10% wide.
+    QCOMPARE(map.lookup(1000, 750, 15), Result::NoDrag);
+    QCOMPARE(map.lookup(1000, 690, 15), Result::Drag);
+    QCOMPARE(map.lookup(2000, 1500, 15), Result::NoDrag);
+}
+
+void tst_TitleBarRegionMap::rowsAreSeparate()
+{
+    const TitleBarRegionMap map({getZone(Anchor::Left, Unit::Percent, 0, 100, true),
+                                 getZone(Anchor::Left, Unit::Pixels, 0, 50, false, 0, 10)});
+    QCOMPARE(map.lookup(800, 20, 5), Result::NoDrag);
+    QCOMPARE(map.lookup(800, 20, 15), Result::Drag);
+    QCOMPARE(map.lookup(800, 60, 5), Result::Drag);
+}
+
+void tst_TitleBarRegionMap::refinesOnlyTheTitleBar()
+{
+    using Region = HitTestEngine::Region;
+    const TitleBarRegionMap map(getTitleBarZones());
+    QCOMPARE(map.refine(Region::Caption, 800, 750, 15), Region::Client);
+    QCOMPARE(map.refine(Region::Client, 800, 400, 15), Region::Caption);
+    QCOMPARE(map.refine(Region::Client, 800, 400, 40), Region::Client);
+    QCOMPARE(map.refine(Region::Caption, 800, 400, 40), Region::Caption);
+    // The resize edges are never refined.
+    QCOMPARE(map.refine(Region::Top, 800, 750, 2), Region::Top);
+    QCOMPARE(map.refine(Region::TopRight, 800, 798, 2), Region::TopRight);
+}
+
+QTEST_APPLESS_MAIN(tst_TitleBarRegionMap)
+
+#include "tst_titlebarregionmap.moc"
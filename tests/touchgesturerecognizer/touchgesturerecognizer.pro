@@ -0,0 +1,4 @@
+TARGET = tst_touchgesturerecognizer
+QT -= gui
+include(../common.pri)
+SOURCES += tst_touchgesturerecognizer.cpp
@@ -0,0 +1,205 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "touchgesturerecognizer.h"
+#include <QtTest>
+
+namespace {
+
+using Recognizer = TouchGestureRecognizer;
+using PointState = Recognizer::PointState;
+using Action = Recognizer::Action;
+using Region = HitTestEngine::Region;
+
+Recognizer::Point getPoint(const int id,
+                           const QPointF &position,
+                           const PointState state,
+                           const Region region = Region::Client,
+                           const qreal diameter = 5)
+{
+    Recognizer::Point point = {};
+    point.id = id;
+    point.position = position;
+    point.diameter = diameter;
+    point.state = state;
+    point.region = region;
+    return point;
+}
+
+// One finger pressed at "start", then moved by a pixel per update, returns
+// how many times each action was requested.
+void drag(Recognizer &recognizer,
+          const QPointF &start,
+          const Region region,
+          const int updates,
+          int *moves,
+          int *others)
+{
+    Recognizer::Point point = getPoint(1, start, PointState::Pressed, region);
+    const auto count = [&recognizer, &point, moves, others]() {
+        const Recognizer::Result result = recognizer.process(&point, 1);
+        if (result.action == Action::MoveOrResize) {
+            ++*moves;
+        } else if (result.action != Action::None) {
+            ++*others;
+        }
+    };
+    count();
+    for (int i = 1; i <= updates; ++i) {
+        point = getPoint(1, {start.x() + i, start.y()}, PointState::Moved);
+        count();
+    }
+    point.state = PointState::Released;
+    count();
+}
+
+} // namespace
+
+class tst_TouchGestureRecognizer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void dragRequestsOneMove();
+    void dragOnEdgeResizes();
+    void tapDoesNothing();
+    void clientAreaIsIgnored();
+    void twoFingerTapToggles();
+    void twoFingerPanIsIgnored();
+    void palmIsIgnored();
+    void palmRejectsGesture();
+};
+
+void tst_TouchGestureRecognizer::dragRequestsOneMove()
+{
+    Recognizer recognizer;
+    // Two seconds of a 120 Hz touch screen.
+    int moves = 0, others = 0;
+    drag(recognizer, {100, 10}, Region::Caption, 240, &moves, &others);
+    QCOMPARE(moves, 1);
+    QCOMPARE(others, 0);
+    // Nothing happens until the next gesture.
+    drag(recognizer, {100, 10}, Region::Caption, 20, &moves, &others);
+    QCOMPARE(moves, 1);
+    recognizer.reset();
+    drag(recognizer, {100, 10}, Region::Caption, 20, &moves, &others);
+    QCOMPARE(moves, 2);
+}
+
+void tst_TouchGestureRecognizer::dragOnEdgeResizes()
+{
+    Recognizer recognizer;
+    Recognizer::Point point = getPoint(1, {2, 100}, PointState::Pressed, Region::Left);
+    QCOMPARE(recognizer.process(&point, 1).action, Action::None);
+    point = getPoint(1, {2 + recognizer.dragDistance(), 100}, PointState::Moved);
+    const Recognizer::Result result = recognizer.process(&point, 1);
+    QCOMPARE(result.action, Action::MoveOrResize);
+    QCOMPARE(result.region, Region::Left);
+}
+
+void tst_TouchGestureRecognizer::tapDoesNothing()
+{
+    Recognizer recognizer;
+    recognizer.setDragDistance(20);
+    int moves = 0, others = 0;
+    drag(recognizer, {100, 10}, Region::Caption, 19, &moves, &others);
+    QCOMPARE(moves, 0);
+    QCOMPARE(others, 0);
+}
+
+void tst_TouchGestureRecognizer::clientAreaIsIgnored()
+{
+    Recognizer recognizer;
+    int moves = 0, others = 0;
+    drag(recognizer, {100, 100}, Region::Client, 100, &moves, &others);
+    drag(recognizer, {2, 100}, Region::FixedBorder, 100, &moves, &others);
+    QCOMPARE(moves, 0);
+    QCOMPARE(others, 0);
+}
+
+void tst_TouchGestureRecognizer::twoFingerTapToggles()
+{
+    Recognizer recognizer;
+    Recognizer::Point points[2] = {getPoint(1, {100, 10}, PointState::Pressed, Region::Caption),
+                                   getPoint(2, {150, 10}, PointState::Pressed, Region::Caption)};
+    QCOMPARE(recognizer.process(points, 2).action, Action::None);
+    points[0].state = PointState::Stationary;
+    points[1].state = PointState::Moved;
+    points[1].position = {152, 11};
+    QCOMPARE(recognizer.process(points, 2).action, Action::None);
+    points[0].state = PointState::Released;
+    points[1].state = PointState::Stationary;
+    QCOMPARE(recognizer.process(points, 2).action, Action::ToggleMaximized);
+    points[1].state = PointState::Released;
+    QCOMPARE(recognizer.process(&points[1], 1).action, Action::None);
+}
+
+void tst_TouchGestureRecognizer::twoFingerPanIsIgnored()
+{
+    Recognizer recognizer;
+    Recognizer::Point points[2] = {getPoint(1, {100, 10}, PointState::Pressed, Region::Caption),
+                                   getPoint(2, {150, 10}, PointState::Pressed, Region::Caption)};
+    recognizer.process(points, 2);
+    for (int i = 1; i <= 50; ++i) {
+        points[0] = getPoint(1, {100.0 + i, 10}, PointState::Moved);
+        points[1] = getPoint(2, {150.0 + i, 10}, PointState::Moved);
+        QCOMPARE(recognizer.process(points, 2).action, Action::None);
+    }
+    points[0].state = PointState::Released;
+    points[1].state = PointState::Released;
+    QCOMPARE(recognizer.process(points, 2).action, Action::None);
+}
+
+void tst_TouchGestureRecognizer::palmIsIgnored()
+{
+    Recognizer recognizer;
+    Recognizer::Point palm = getPoint(1, {100, 10}, PointState::Pressed, Region::Caption, 200);
+    QCOMPARE(recognizer.process(&palm, 1).action, Action::None);
+    palm = getPoint(1, {200, 10}, PointState::Moved, Region::Client, 200);
+    QCOMPARE(recognizer.process(&palm, 1).action, Action::None);
+    // The same contact counts as a finger without the palm rejection.
+    recognizer.reset();
+    recognizer.setPalmDiameter(0);
+    palm = getPoint(1, {100, 10}, PointState::Pressed, Region::Caption, 200);
+    recognizer.process(&palm, 1);
+    palm = getPoint(1, {200, 10}, PointState::Moved, Region::Client, 200);
+    QCOMPARE(recognizer.process(&palm, 1).action, Action::MoveOrResize);
+}
+
+void tst_TouchGestureRecognizer::palmRejectsGesture()
+{
+    Recognizer recognizer;
+    Recognizer::Point point = getPoint(1, {100, 10}, PointState::Pressed, Region::Caption);
+    recognizer.process(&point, 1);
+    // The finger turns out to be the side of the hand.
+    point = getPoint(1, {101, 10}, PointState::Moved, Region::Client, 200);
+    QCOMPARE(recognizer.process(&point, 1).action, Action::None);
+    point = getPoint(1, {200, 10}, PointState::Moved);
+    QCOMPARE(recognizer.process(&point, 1).action, Action::None);
+}
+
+QTEST_APPLESS_MAIN(tst_TouchGestureRecognizer)
+
+#include "tst_touchgesturerecognizer.moc"
@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "windowsnapper.h"
+#include <QtTest>
+
+namespace {
+
+using Tile = WindowSnapper::Tile;
+
+// A 1080p screen with a 40 pixels high panel at the bottom, and a 1440p
+// screen on its right.
+QVector<WindowSnapper::Screen> getScreens()
+{
+    QVector<WindowSnapper::Screen> screens;
+    screens.append({QRect(0, 0, 1920, 1080), QRect(0, 0, 1920, 1040), 1.0});
+    screens.append({QRect(1920, 0, 2560, 1440), QRect(1920, 0, 2560, 1440), 1.5});
+    return screens;
+}
+
+} // namespace
+
+class tst_WindowSnapper : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void tilesAtScreenEdges();
+    void tilesCoverTheScreen();
+    void snapsToNearbyEdges();
+    void snapsToTheClosestEdge();
+};
+
+void tst_WindowSnapper::tilesAtScreenEdges()
+{
+    const QVector<WindowSnapper::Screen> screens = getScreens();
+    int screen = -2;
+    QCOMPARE(WindowSnapper::getTile(screens, {5, 500}, 10, &screen), Tile::LeftHalf);
+    QCOMPARE(screen, 0);
+    QCOMPARE(WindowSnapper::getTile(screens, {960, 5}, 10), Tile::Maximized);
+    QCOMPARE(WindowSnapper::getTile(screens, {1915, 5}, 10), Tile::TopRightQuarter);
+    QCOMPARE(WindowSnapper::getTile(screens, {1915, 500}, 10), Tile::RightHalf);
+    QCOMPARE(WindowSnapper::getTile(screens, {960, 500}, 10, &screen), Tile::None);
+    QCOMPARE(screen, 0);
+    // The panel counts as the bottom edge.
+    QCOMPARE(WindowSnapper::getTile(screens, {5, 1070}, 10), Tile::BottomLeftQuarter);
+    QCOMPARE(WindowSnapper::getTile(screens, {960, 1070}, 10), Tile::None);
+    QCOMPARE(WindowSnapper::getTile(screens, {4470, 1435}, 10, &screen),
+             Tile::BottomRightQuarter);
+    QCOMPARE(screen, 1);
+    QCOMPARE(WindowSnapper::getTile(screens, {1925, 700}, 10, &screen), Tile::LeftHalf);
+    QCOMPARE(screen, 1);
+    // Between the screens.
+    QCOMPARE(WindowSnapper::getTile(screens, {1000, 1200}, 10, &screen), Tile::None);
+    QCOMPARE(screen, -1);
+}
+
+void tst_WindowSnapper::tilesCoverTheScreen()
+{
+    // Odd sizes, so the halves differ by a pixel.
+    const QRect available(10, 20, 1921, 1041);
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::None), QRect());
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::Maximized), available);
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::LeftHalf), QRect(10, 20, 960, 1041));
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::RightHalf),
+             QRect(970, 20, 961, 1041));
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::TopLeftQuarter),
+             QRect(10, 20, 960, 520));
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::TopRightQuarter),
+             QRect(970, 20, 961, 520));
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::BottomLeftQuarter),
+             QRect(10, 540, 960, 521));
+    QCOMPARE(WindowSnapper::getTileGeometry(available, Tile::BottomRightQuarter),
+             QRect(970, 540, 961, 521));
+}
+
+void tst_WindowSnapper::snapsToNearbyEdges()
+{
+    const QVector<WindowSnapper::Screen> screens = getScreens();
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {8, 100, 400, 300}, 16),
+             QRect(0, 100, 400, 300));
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {1515, 730, 400, 300}, 16),
+             QRect(1520, 740, 400, 300));
+    // Too far, or snapping disabled.
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {17, 100, 400, 300}, 16),
+             QRect(17, 100, 400, 300));
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {8, 100, 400, 300}, 0),
+             QRect(8, 100, 400, 300));
+    // Below the first screen, only the second one is within reach.
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {1930, 1300, 400, 300}, 16),
+             QRect(1920, 1300, 400, 300));
+}
+
+void tst_WindowSnapper::snapsToTheClosestEdge()
+{
+    const QVector<WindowSnapper::Screen> screens = getScreens();
+    // The smaller offset wins: 8 pixels to the left edge rather than 12 to
+    // the right one, then 6 to the right edge rather than 14 to the left one.
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {8, 100, 1900, 300}, 16),
+             QRect(0, 100, 1900, 300));
+    QCOMPARE(WindowSnapper::snapToEdges(screens, {14, 100, 1900, 300}, 16),
+             QRect(20, 100, 1900, 300));
+}
+
+QTEST_APPLESS_MAIN(tst_WindowSnapper)
+
+#include "tst_windowsnapper.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_windowsnapper
+QT -= gui
+include(../common.pri)
+SOURCES += tst_windowsnapper.cpp
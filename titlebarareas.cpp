@@ -0,0 +1,190 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "titlebarareas.h"
+
+TitleBarAreas::TitleBarAreas(QObject *parent) : QObject(parent) {}
+
+void TitleBarAreas::addIgnoredObject(QObject *object)
+{
+    m_ignoredObjects.addObject(object);
+}
+
+void TitleBarAreas::addIgnoredObjects(const QObjectList &objects)
+{
+    m_ignoredObjects.addObjects(objects);
+}
+
+void TitleBarAreas::removeIgnoredObject(const QObject *object)
+{
+    m_ignoredObjects.removeObject(object);
+}
+
+void TitleBarAreas::clearIgnoredObjects()
+{
+    m_ignoredObjects.clear();
+}
+
+void TitleBarAreas::setIgnoredObjects(const QObjectList &objects)
+{
+    m_ignoredObjects.setObjects(objects);
+}
+
+QObjectList TitleBarAreas::ignoredObjects() const
+{
+    return m_ignoredObjects.objects();
+}
+
+void TitleBarAreas::addIgnoredRegion(const QRegion &region)
+{
+    m_ignoredShapes.addRegion(region);
+}
+
+void TitleBarAreas::addIgnoredPath(const QPainterPath &path)
+{
+    m_ignoredShapes.addPath(path);
+}
+
+void TitleBarAreas::addDragObject(QObject *object)
+{
+    m_dragObjects.addObject(object);
+}
+
+QObjectList TitleBarAreas::dragObjects() const
+{
+    return m_dragObjects.objects();
+}
+
+void TitleBarAreas::addDragRect(const QRectF &rect)
+{
+    if (rect.isEmpty()) {
+        return;
+    }
+    QPainterPath path = {};
+    path.addRect(rect);
+    m_dragShapes.addPath(path);
+}
+
+bool TitleBarAreas::isDragAllowListEnabled() const
+{
+    return m_dragAllowList;
+}
+
+void TitleBarAreas::setDragAllowListEnabled(const bool enabled)
+{
+    if (m_dragAllowList == enabled) {
+        return;
+    }
+    m_dragAllowList = enabled;
+    ++m_generation;
+}
+
+bool TitleBarAreas::isZOrderHitTestEnabled() const
+{
+    return m_zOrderHitTest;
+}
+
+void TitleBarAreas::setZOrderHitTestEnabled(const bool enabled)
+{
+    if (m_zOrderHitTest == enabled) {
+        return;
+    }
+    m_zOrderHitTest = enabled;
+    ++m_generation;
+}
+
+TitleBarRegionMap TitleBarAreas::regionMap() const
+{
+    return m_regionMap;
+}
+
+void TitleBarAreas::setRegionMap(const TitleBarRegionMap &map)
+{
+    m_regionMap = map;
+    ++m_generation;
+}
+
+HitTestEngine::Callback TitleBarAreas::hitTestCallback() const
+{
+    return m_hitTestCallback;
+}
+
+void TitleBarAreas::setHitTestCallback(const HitTestEngine::Callback &callback)
+{
+    m_hitTestCallback = callback;
+}
+
+bool TitleBarAreas::hitTestOverride(const QPointF &point, HitTestEngine::Region *region) const
+{
+    Q_ASSERT(region);
+    if (!m_hitTestCallback) {
+        return false;
+    }
+    // The callback may write the region and still decline, which must not
+    // leak into the result of the callers.
+    HitTestEngine::Region result = *region;
+    if (!m_hitTestCallback(point, &result)) {
+        return false;
+    }
+    *region = result;
+    return true;
+}
+
+quint64 TitleBarAreas::generation() const
+{
+    return m_generation + m_ignoredObjects.generation() + m_dragObjects.generation()
+           + m_ignoredShapes.generation() + m_dragShapes.generation();
+}
+
+HitTestEngine::Region TitleBarAreas::refine(const HitTestEngine::Region region,
+                                            const qreal windowWidth,
+                                            const QPointF &point,
+                                            const qreal devicePixelRatio) const
+{
+    if ((region != HitTestEngine::Region::Caption) && (region != HitTestEngine::Region::Client)) {
+        return region;
+    }
+    const auto containsObject = [this, &point](FramelessObjectIndex &index) -> bool {
+        return m_zOrderHitTest ? index.containsTopmost(point) : index.contains(point);
+    };
+    HitTestEngine::Region result = region;
+    if (m_dragAllowList) {
+        // Both indices only look at the few drag areas, however many
+        // controls the title bar has.
+        const bool isDragArea = containsObject(m_dragObjects)
+                                || m_dragShapes.contains(point, devicePixelRatio);
+        result = isDragArea ? HitTestEngine::Region::Caption : HitTestEngine::Region::Client;
+    }
+    if (!m_regionMap.isEmpty()) {
+        result = m_regionMap.refine(result, windowWidth, point.x(), point.y());
+    }
+    // Only look into the ignored areas when they can change the result.
+    if ((result == HitTestEngine::Region::Caption)
+        && (containsObject(m_ignoredObjects)
+            || m_ignoredShapes.contains(point, devicePixelRatio))) {
+        result = HitTestEngine::Region::Client;
+    }
+    return result;
+}
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include "framelessobjectindex.h"
+#include "framelessregionindex.h"
+#include "hittestengine.h"
+#include "titlebarregionmap.h"
+
+// Everything that decides which part of the title bar of one window drags it:
+// the ignored objects and shapes, the explicit drag objects and rectangles
+// and the declarative zone map. Both back ends keep one of these per window
+// (as a child of the window) and run the result of HitTestEngine through
+// refine().
+//
+// By default the whole title bar strip drags the window, minus the ignored
+// areas. In allow-list mode nothing drags the window except the registered
+// drag areas, which suits title bars that are mostly made of controls.
+class TitleBarAreas : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TitleBarAreas)
+
+public:
+    explicit TitleBarAreas(QObject *parent = nullptr);
+    ~TitleBarAreas() override = default;
+
+    void addIgnoredObject(QObject *object);
+    void addIgnoredObjects(const QObjectList &objects);
+    void removeIgnoredObject(const QObject *object);
+    void clearIgnoredObjects();
+    void setIgnoredObjects(const QObjectList &objects);
+    QObjectList ignoredObjects() const;
+    void addIgnoredRegion(const QRegion &region);
+    void addIgnoredPath(const QPainterPath &path);
+
+    void addDragObject(QObject *object);
+    QObjectList dragObjects() const;
+    void addDragRect(const QRectF &rect);
+
+    bool isDragAllowListEnabled() const;
+    void setDragAllowListEnabled(const bool enabled);
+
+    // Resolve the topmost object under the point instead of testing the
+    // registered objects one by one, see FramelessObjectIndex::containsTopmost().
+    bool isZOrderHitTestEnabled() const;
+    void setZOrderHitTestEnabled(const bool enabled);
+
+    TitleBarRegionMap regionMap() const;
+    void setRegionMap(const TitleBarRegionMap &map);
+
+    HitTestEngine::Callback hitTestCallback() const;
+    void setHitTestCallback(const HitTestEngine::Callback &callback);
+    // Runs the hit test callback, if any. It's called on every hit test,
+    // before the memo, since we can't know what its result depends on.
+    // "region" is only written when the callback returns true.
+    bool hitTestOverride(const QPointF &point, HitTestEngine::Region *region) const;
+
+    // Bumped whenever the result of refine() may have changed.
+    quint64 generation() const;
+
+    // "point" is in the window's coordinate system, in logical pixels. Only
+    // Caption and Client are changed, the resize edges always win.
+    HitTestEngine::Region refine(const HitTestEngine::Region region,
+                                 const qreal windowWidth,
+                                 const QPointF &point,
+                                 const qreal devicePixelRatio) const;
+
+private:
+    // Their rectangles are refreshed lazily, by the queries.
+    mutable FramelessObjectIndex m_ignoredObjects;
+    mutable FramelessObjectIndex m_dragObjects;
+    FramelessRegionIndex m_ignoredShapes = {};
+    FramelessRegionIndex m_dragShapes = {};
+    TitleBarRegionMap m_regionMap = {};
+    HitTestEngine::Callback m_hitTestCallback = nullptr;
+    bool m_dragAllowList = false;
+    bool m_zOrderHitTest = false;
+    quint64 m_generation = 0;
+};
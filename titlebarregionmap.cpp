@@ -0,0 +1,221 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "titlebarregionmap.h"
+#include <algorithm>
+
+namespace {
+
+struct Interval
+{
+    qreal start = 0.0;
+    qreal end = 0.0;
+    bool draggable = true;
+};
+
+// The position of a zone relative to its anchor, in its own unit.
+Interval getInterval(const TitleBarRegionMap::Zone &zone)
+{
+    Interval interval = {};
+    switch (zone.anchor) {
+    case TitleBarRegionMap::Anchor::Left:
+        interval.start = zone.offset;
+        break;
+    case TitleBarRegionMap::Anchor::Right:
+        interval.start = -zone.offset - zone.width;
+        break;
+    case TitleBarRegionMap::Anchor::Center:
+        interval.start = zone.offset - (zone.width / 2.0);
+        break;
+    }
+    interval.end = interval.start + zone.width;
+    interval.draggable = zone.draggable;
+    return interval;
+}
+
+} // namespace
+
+TitleBarRegionMap::TitleBarRegionMap(const QVector<Zone> &zones)
+{
+    setZones(zones);
+}
+
+void TitleBarRegionMap::setZones(const QVector<Zone> &zones)
+{
+    m_zones = zones;
+    compile();
+}
+
+QVector<TitleBarRegionMap::Zone> TitleBarRegionMap::zones() const
+{
+    return m_zones;
+}
+
+bool TitleBarRegionMap::isEmpty() const
+{
+    return m_rows.isEmpty();
+}
+
+int TitleBarRegionMap::tableIndex(const Anchor anchor, const Unit unit)
+{
+    return (static_cast<int>(anchor) * 2) + static_cast<int>(unit);
+}
+
+TitleBarRegionMap::Result TitleBarRegionMap::lookup(const qreal windowWidth,
+                                                    const qreal x,
+                                                    const qreal y) const
+{
+    if (m_rows.isEmpty() || (y < m_rows.first().top) || (y >= m_bottom)) {
+        return Result::Unspecified;
+    }
+    const auto rowIt = std::upper_bound(m_rows.cbegin(),
+                                        m_rows.cend(),
+                                        y,
+                                        [](const qreal value, const Row &row) {
+                                            return value < row.top;
+                                        });
+    const Row &row = *(rowIt - 1);
+    const qreal origins[] = {0.0, windowWidth, windowWidth / 2.0};
+    Result result = Result::Unspecified;
+    for (int anchor = 0; anchor != 3; ++anchor) {
+        for (int unit = 0; unit != 2; ++unit) {
+            const QVector<Segment> &table = row.tables[(anchor * 2) + unit];
+            if (table.isEmpty()) {
+                continue;
+            }
+            qreal position = x - origins[anchor];
+            if (static_cast<Unit>(unit) == Unit::Percent) {
+                if (windowWidth <= 0.0) {
+                    continue;
+                }
+                position = position * 100.0 / windowWidth;
+            }
+            const auto it = std::upper_bound(table.cbegin(),
+                                             table.cend(),
+                                             position,
+                                             [](const qreal value, const Segment &segment) {
+                                                 return value < segment.start;
+                                             });
+            if (it == table.cbegin()) {
+                continue;
+            }
+            const Result segmentResult = (it - 1)->result;
+            if (segmentResult == Result::NoDrag) {
+                return Result::NoDrag;
+            }
+            if (segmentResult == Result::Drag) {
+                result = Result::Drag;
+            }
+        }
+    }
+    return result;
+}
+
+HitTestEngine::Region TitleBarRegionMap::refine(const HitTestEngine::Region region,
+                                                const qreal windowWidth,
+                                                const qreal x,
+                                                const qreal y) const
+{
+    if ((region != HitTestEngine::Region::Caption) && (region != HitTestEngine::Region::Client)) {
+        return region;
+    }
+    switch (lookup(windowWidth, x, y)) {
+    case Result::Drag:
+        return HitTestEngine::Region::Caption;
+    case Result::NoDrag:
+        return HitTestEngine::Region::Client;
+    case Result::Unspecified:
+        break;
+    }
+    return region;
+}
+
+void TitleBarRegionMap::compile()
+{
+    m_rows.clear();
+    m_bottom = 0.0;
+    const auto isValid = [](const Zone &zone) -> bool {
+        return (zone.width > 0.0) && (zone.height > 0.0);
+    };
+    QVector<qreal> edges = {};
+    for (auto &&zone : qAsConst(m_zones)) {
+        if (isValid(zone)) {
+            edges.append(zone.top);
+            edges.append(zone.top + zone.height);
+        }
+    }
+    if (edges.isEmpty()) {
+        return;
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    m_bottom = edges.last();
+    m_rows.reserve(edges.size() - 1);
+    for (int i = 0; i != (edges.size() - 1); ++i) {
+        Row row = {};
+        row.top = edges.at(i);
+        const qreal bottom = edges.at(i + 1);
+        for (int table = 0; table != m_tableCount; ++table) {
+            QVector<Interval> intervals = {};
+            QVector<qreal> bounds = {};
+            for (auto &&zone : qAsConst(m_zones)) {
+                if (!isValid(zone) || (tableIndex(zone.anchor, zone.unit) != table)
+                    || (zone.top > row.top) || ((zone.top + zone.height) < bottom)) {
+                    continue;
+                }
+                const Interval interval = getInterval(zone);
+                intervals.append(interval);
+                bounds.append(interval.start);
+                bounds.append(interval.end);
+            }
+            if (intervals.isEmpty()) {
+                continue;
+            }
+            std::sort(bounds.begin(), bounds.end());
+            bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+            // Flatten the (possibly overlapping) intervals into disjoint
+            // segments, merging the neighbours with the same result.
+            QVector<Segment> &segments = row.tables[table];
+            for (int j = 0; j != (bounds.size() - 1); ++j) {
+                Result result = Result::Unspecified;
+                for (auto &&interval : qAsConst(intervals)) {
+                    if ((interval.start > bounds.at(j)) || (interval.end < bounds.at(j + 1))) {
+                        continue;
+                    }
+                    if (!interval.draggable) {
+                        result = Result::NoDrag;
+                        break;
+                    }
+                    result = Result::Drag;
+                }
+                if (segments.isEmpty() || (segments.last().result != result)) {
+                    segments.append({bounds.at(j), result});
+                }
+            }
+            segments.append({bounds.last(), Result::Unspecified});
+        }
+        m_rows.append(row);
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include "hittestengine.h"
+#include <QVector>
+
+// A declarative description of the title bar: a list of draggable and
+// non-draggable zones, each one anchored to the left edge, the right edge or
+// the center of the window, with a width in pixels or in percents of the
+// window width.
+//
+// The zones are compiled once into per-row tables of sorted intervals. The
+// intervals are stored relative to their anchor, in their own unit, so they
+// stay valid at any window width and a lookup is a binary search per table,
+// no matter how often the window is resized.
+class FRAMELESSHELPER_EXPORT TitleBarRegionMap
+{
+public:
+    enum class Anchor : quint8 { Left, Right, Center };
+    enum class Unit : quint8 { Pixels, Percent };
+    enum class Result : quint8 { Unspecified, Drag, NoDrag };
+
+    struct Zone
+    {
+        Anchor anchor = Anchor::Left;
+        // The unit of both "offset" and "width".
+        Unit unit = Unit::Pixels;
+        // Distance from the anchor: from the left edge to the left side of
+        // the zone, from the right edge to the right side of the zone, or
+        // from the center of the window to the center of the zone.
+        qreal offset = 0.0;
+        qreal width = 0.0;
+        // Always in pixels, from the top of the window.
+        qreal top = 0.0;
+        qreal height = 0.0;
+        bool draggable = true;
+    };
+
+    explicit TitleBarRegionMap() = default;
+    explicit TitleBarRegionMap(const QVector<Zone> &zones);
+    ~TitleBarRegionMap() = default;
+
+    void setZones(const QVector<Zone> &zones);
+    QVector<Zone> zones() const;
+    bool isEmpty() const;
+
+    // "x" and "y" are in the window's coordinate system, in the same unit as
+    // the zones. A non-draggable zone wins over a draggable one.
+    Result lookup(const qreal windowWidth, const qreal x, const qreal y) const;
+
+    // Turns a Caption/Client result of HitTestEngine into the one of the
+    // zone the point is in, if any. The resize edges are left untouched.
+    HitTestEngine::Region refine(const HitTestEngine::Region region,
+                                 const qreal windowWidth,
+                                 const qreal x,
+                                 const qreal y) const;
+
+private:
+    // One table per anchor and unit combination.
+    static constexpr int m_tableCount = 6;
+
+    static int tableIndex(const Anchor anchor, const Unit unit);
+
+    // Covers [start, start of the next segment), the last segment of a table
+    // is always Unspecified.
+    struct Segment
+    {
+        qreal start = 0.0;
+        Result result = Result::Unspecified;
+    };
+
+    struct Row
+    {
+        qreal top = 0.0;
+        QVector<Segment> tables[m_tableCount] = {};
+    };
+
+    void compile();
+
+    QVector<Zone> m_zones = {};
+    QVector<Row> m_rows = {};
+    // The bottom of the last row.
+    qreal m_bottom = 0.0;
+};
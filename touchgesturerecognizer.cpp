@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "touchgesturerecognizer.h"
+
+qreal TouchGestureRecognizer::dragDistance() const
+{
+    return m_dragDistance;
+}
+
+void TouchGestureRecognizer::setDragDistance(const qreal val)
+{
+    m_dragDistance = val;
+}
+
+qreal TouchGestureRecognizer::palmDiameter() const
+{
+    return m_palmDiameter;
+}
+
+void TouchGestureRecognizer::setPalmDiameter(const qreal val)
+{
+    m_palmDiameter = val;
+}
+
+bool TouchGestureRecognizer::isPalm(const Point &point) const
+{
+    return (m_palmDiameter > 0.0) && (point.diameter > m_palmDiameter);
+}
+
+TouchGestureRecognizer::Result TouchGestureRecognizer::process(const Point *points,
+                                                               const int count)
+{
+    Result result = {};
+    if (m_done || (count <= 0)) {
+        return result;
+    }
+    Q_ASSERT(points);
+    for (int i = 0; i != count; ++i) {
+        const Point &point = points[i];
+        const bool isPrimary = (point.id == m_primaryId);
+        const bool isSecondary = (point.id == m_secondaryId);
+        if (isPalm(point)) {
+            if (isPrimary || isSecondary) {
+                // What looked like a finger was the side of the hand.
+                m_done = true;
+                return result;
+            }
+            continue;
+        }
+        switch (point.state) {
+        case PointState::Pressed:
+            if (m_primaryId < 0) {
+                if ((point.region != HitTestEngine::Region::Client)
+                    && (point.region != HitTestEngine::Region::FixedBorder)) {
+                    m_primaryId = point.id;
+                    m_primaryStart = point.position;
+                    m_region = point.region;
+                }
+            } else if ((m_secondaryId < 0) && !isPrimary
+                       && (m_region == HitTestEngine::Region::Caption)
+                       && (point.region == HitTestEngine::Region::Caption)) {
+                m_secondaryId = point.id;
+                m_secondaryStart = point.position;
+            }
+            break;
+        case PointState::Moved:
+        case PointState::Stationary:
+            if (isPrimary || isSecondary) {
+                const QPointF start = isPrimary ? m_primaryStart : m_secondaryStart;
+                if ((point.position - start).manhattanLength() >= m_dragDistance) {
+                    m_moved = true;
+                }
+            }
+            break;
+        case PointState::Released:
+            if (isPrimary || isSecondary) {
+                m_released = true;
+            }
+            break;
+        }
+    }
+    if (m_primaryId < 0) {
+        return result;
+    }
+    if (m_secondaryId >= 0) {
+        if (m_moved) {
+            // Two fingers moving around: a pan or a pinch, not for us.
+            m_done = true;
+        } else if (m_released) {
+            result.action = Action::ToggleMaximized;
+            m_done = true;
+        }
+    } else if (m_released) {
+        // A tap on the title bar.
+        m_done = true;
+    } else if (m_moved) {
+        result.action = Action::MoveOrResize;
+        result.region = m_region;
+        m_done = true;
+    }
+    return result;
+}
+
+void TouchGestureRecognizer::reset()
+{
+    m_primaryId = -1;
+    m_secondaryId = -1;
+    m_primaryStart = {};
+    m_secondaryStart = {};
+    m_region = HitTestEngine::Region::Client;
+    m_moved = false;
+    m_released = false;
+    m_done = false;
+}
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include "hittestengine.h"
+#include <QPointF>
+
+// Turns the touch events of one window into at most one window action per
+// gesture. It only deals with plain numbers, the caller classifies the newly
+// pressed points and carries out the action.
+//
+// The first finger which lands on the title bar or on an edge becomes the
+// primary point: once it has travelled the drag distance, one system move or
+// resize is requested and the rest of the gesture is ignored. A second finger
+// landing on the title bar turns the gesture into a two-finger tap, which
+// toggles the maximized state when one of them is lifted without moving.
+// Any other point, and any contact larger than the palm diameter, is ignored;
+// a palm on top of a tracked point rejects the whole gesture.
+class FRAMELESSHELPER_EXPORT TouchGestureRecognizer
+{
+public:
+    enum class PointState : quint8 { Pressed, Moved, Stationary, Released };
+    enum class Action : quint8 { None, MoveOrResize, ToggleMaximized };
+
+    struct Point
+    {
+        int id = -1;
+        QPointF position = {};
+        // The larger diameter of the contact ellipse, 0 if unknown.
+        qreal diameter = 0.0;
+        PointState state = PointState::Stationary;
+        // Only needed for pressed points.
+        HitTestEngine::Region region = HitTestEngine::Region::Client;
+    };
+
+    struct Result
+    {
+        Action action = Action::None;
+        // The region to move or resize by.
+        HitTestEngine::Region region = HitTestEngine::Region::Client;
+    };
+
+    // Roughly 26 mm at 96 DPI.
+    static constexpr qreal defaultPalmDiameter = 100.0;
+
+    explicit TouchGestureRecognizer() = default;
+    ~TouchGestureRecognizer() = default;
+
+    qreal dragDistance() const;
+    void setDragDistance(const qreal val);
+
+    // 0 disables the palm rejection.
+    qreal palmDiameter() const;
+    void setPalmDiameter(const qreal val);
+
+    // To be called once per touch event, with all its points.
+    Result process(const Point *points, const int count);
+    // To be called when the gesture ends (TouchEnd, TouchCancel).
+    void reset();
+
+private:
+    bool isPalm(const Point &point) const;
+
+    qreal m_dragDistance = 10.0;
+    qreal m_palmDiameter = defaultPalmDiameter;
+    int m_primaryId = -1, m_secondaryId = -1;
+    QPointF m_primaryStart = {}, m_secondaryStart = {};
+    HitTestEngine::Region m_region = HitTestEngine::Region::Client;
+    bool m_moved = false;
+    bool m_released = false;
+    // Set once the action of the gesture has been taken, or once the gesture
+    // has been rejected: nothing else happens until reset().
+    bool m_done = false;
+};
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "windowsnapper.h"
+
+namespace {
+
+using Tile = WindowSnapper::Tile;
+
+// Indexed by [top, middle, bottom][left, middle, right].
+constexpr Tile m_tiles[3][3] = {{Tile::TopLeftQuarter, Tile::Maximized, Tile::TopRightQuarter},
+                                {Tile::LeftHalf, Tile::None, Tile::RightHalf},
+                                {Tile::BottomLeftQuarter, Tile::None, Tile::BottomRightQuarter}};
+
+// The offset which brings "edge" onto the closest of the two targets, if
+// it's within "distance". The smaller offset wins.
+void snapEdge(const int edge, const int target, const int distance, int *offset)
+{
+    Q_ASSERT(offset);
+    const int delta = target - edge;
+    if ((qAbs(delta) <= distance) && (qAbs(delta) < qAbs(*offset))) {
+        *offset = delta;
+    }
+}
+
+} // namespace
+
+WindowSnapper::Tile WindowSnapper::getTile(const QVector<Screen> &screens,
+                                           const QPoint &cursor,
+                                           const int distance,
+                                           int *screenIndex)
+{
+    if (screenIndex) {
+        *screenIndex = -1;
+    }
+    for (int i = 0; i != screens.size(); ++i) {
+        // The cursor can reach the whole screen, including the panels.
+        if (!screens.at(i).geometry.contains(cursor)) {
+            continue;
+        }
+        if (screenIndex) {
+            *screenIndex = i;
+        }
+        const QRect &available = screens.at(i).availableGeometry;
+        const int row = (cursor.y() <= (available.top() + distance))
+                            ? 0
+                            : ((cursor.y() >= (available.bottom() - distance)) ? 2 : 1);
+        const int column = (cursor.x() <= (available.left() + distance))
+                               ? 0
+                               : ((cursor.x() >= (available.right() - distance)) ? 2 : 1);
+        return m_tiles[row][column];
+    }
+    return Tile::None;
+}
+
+QRect WindowSnapper::getTileGeometry(const QRect &availableGeometry, const Tile tile)
+{
+    const int halfWidth = availableGeometry.width() / 2;
+    const int halfHeight = availableGeometry.height() / 2;
+    const QRect &a = availableGeometry;
+    switch (tile) {
+    case Tile::None:
+        break;
+    case Tile::Maximized:
+        return a;
+    case Tile::LeftHalf:
+        return {a.left(), a.top(), halfWidth, a.height()};
+    case Tile::RightHalf:
+        return {a.left() + halfWidth, a.top(), a.width() - halfWidth, a.height()};
+    case Tile::TopLeftQuarter:
+        return {a.left(), a.top(), halfWidth, halfHeight};
+    case Tile::TopRightQuarter:
+        return {a.left() + halfWidth, a.top(), a.width() - halfWidth, halfHeight};
+    case Tile::BottomLeftQuarter:
+        return {a.left(), a.top() + halfHeight, halfWidth, a.height() - halfHeight};
+    case Tile::BottomRightQuarter:
+        return {a.left() + halfWidth,
+                a.top() + halfHeight,
+                a.width() - halfWidth,
+                a.height() - halfHeight};
+    }
+    return {};
+}
+
+QRect WindowSnapper::snapToEdges(const QVector<Screen> &screens,
+                                 const QRect &geometry,
+                                 const int distance)
+{
+    if (distance <= 0) {
+        return geometry;
+    }
+    // Anything above "distance" means "no snap".
+    int dx = distance + 1, dy = distance + 1;
+    const QRect reach = geometry.adjusted(-distance, -distance, distance, distance);
+    for (auto &&screen : qAsConst(screens)) {
+        const QRect &available = screen.availableGeometry;
+        if (!available.intersects(reach)) {
+            continue;
+        }
+        snapEdge(geometry.left(), available.left(), distance, &dx);
+        snapEdge(geometry.right(), available.right(), distance, &dx);
+        snapEdge(geometry.top(), available.top(), distance, &dy);
+        snapEdge(geometry.bottom(), available.bottom(), distance, &dy);
+    }
+    return geometry.translated((dx > distance) ? 0 : dx, (dy > distance) ? 0 : dy);
+}
@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "framelesshelper_global.h"
+#include <QRect>
+#include <QVector>
+
+// The snapping rules of a window being moved by hand: window edges are
+// pulled onto nearby screen edges while moving, and dropping the window with
+// the cursor on a screen edge tiles it, the way most window managers do. It
+// only deals with plain geometry, the screens are passed in by the caller
+// (see ScreenTopology), and every function is a single pass over them.
+class FRAMELESSHELPER_EXPORT WindowSnapper
+{
+public:
+    enum class Tile : quint8 {
+        None,
+        Maximized,
+        LeftHalf,
+        RightHalf,
+        TopLeftQuarter,
+        TopRightQuarter,
+        BottomLeftQuarter,
+        BottomRightQuarter
+    };
+
+    struct Screen
+    {
+        QRect geometry = {};
+        QRect availableGeometry = {};
+        qreal devicePixelRatio = 1.0;
+    };
+
+    // The tile the window would get if dropped with the cursor at "cursor":
+    // within "distance" of the top edge of the available geometry maximizes,
+    // the left and right edges give halves and the corners give quarters.
+    // "screenIndex" receives the screen the cursor is on (-1 if none).
+    static Tile getTile(const QVector<Screen> &screens,
+                        const QPoint &cursor,
+                        const int distance,
+                        int *screenIndex = nullptr);
+    static QRect getTileGeometry(const QRect &availableGeometry, const Tile tile);
+
+    // Moves "geometry" so that its edges stick to the edges of the available
+    // geometry of the screens it touches, when they are closer than
+    // "distance".
+    static QRect snapToEdges(const QVector<Screen> &screens,
+                             const QRect &geometry,
+                             const int distance);
+};
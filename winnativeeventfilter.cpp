@@ -32,10 +32,17 @@
 
 #include "winnativeeventfilter.h"
 
+#include "framelesswindowstore.h"
+#include "hittestengine.h"
+#include "systemmetriccache.h"
+#include "titlebarareas.h"
 #include <d2d1.h>
 #include <QDebug>
 #include <QGuiApplication>
+#include <QHash>
 #include <QLibrary>
+#include <QPointer>
+#include <QPlatformSurfaceEvent>
 #include <QSettings>
 #include <QWindow>
 #include <QtMath>
@@ -699,8 +706,6 @@ namespace {
 
 const quint32 m_defaultDotsPerInch = USER_DEFAULT_SCREEN_DPI;
 
-const qreal m_defaultDevicePixelRatio = 1.0;
-
 const char envVarUseNativeTitleBar[] = "WNEF_USE_NATIVE_TITLE_BAR";
 const char envVarPreserveWindowFrame[] = "WNEF_PRESERVE_WINDOW_FRAME";
 const char envVarForceWindowFrame[] = "WNEF_FORCE_PRESERVE_WINDOW_FRAME";
@@ -748,21 +753,6 @@ bool isDwmCompositionEnabled()
            && enabled;
 }
 
-QWindow *findWindow(const HWND handle)
-{
-    Q_ASSERT(handle);
-    const auto wid = reinterpret_cast<WId>(handle);
-    const QWindowList windows = QGuiApplication::topLevelWindows();
-    for (auto &&window : qAsConst(windows)) {
-        if (window && window->handle()) {
-            if (window->winId() == wid) {
-                return window;
-            }
-        }
-    }
-    return nullptr;
-}
-
 void triggerFrameChange(const QWindow *window)
 {
     Q_ASSERT(window);
@@ -789,10 +779,6 @@ void updateFrameMargins(const QWindow *window, bool reset)
                         &margins)
 }
 
-// The standard values of border width, border height and title bar height
-// when DPI is 96.
-const int m_defaultBorderWidth = 8, m_defaultBorderHeight = 8, m_defaultTitleBarHeight = 31;
-
 // The thickness of an auto-hide taskbar in pixels.
 const int kAutoHideTaskbarThicknessPx = 2;
 const int kAutoHideTaskbarThicknessPy = kAutoHideTaskbarThicknessPx;
@@ -802,11 +788,216 @@ const QString g_sDwmRegistryKey = QString::fromUtf8(
 const QString g_sPersonalizeRegistryKey = QString::fromUtf8(
     R"(HKEY_CURRENT_USER\Software\Microsoft\Windows\CurrentVersion\Themes\Personalize)");
 
-const char m_framelessMode[] = "_WNEF_FRAMELESS_MODE_ENABLED";
-const char m_borderWidth[] = "_WNEF_WINDOW_BORDER_WIDTH";
-const char m_borderHeight[] = "_WNEF_WINDOW_BORDER_HEIGHT";
-const char m_titleBarHeight[] = "_WNEF_TITLE_BAR_HEIGHT";
-const char m_ignoredObjects[] = "_WNEF_TITLE_BAR_IGNORED_OBJECTS";
+struct WindowState
+{
+    const QWindow *window = nullptr;
+    bool framelessMode = false;
+    // Indexed in WindowStates::handles while the window is frameless and
+    // its native window exists.
+    HWND handle = nullptr;
+    QPointer<QObject> surfaceWatcher = nullptr;
+    QPointer<TitleBarAreas> titleBarAreas = nullptr;
+    HitTestCache hitTestCache = {};
+    // The size constraints don't send any message of their own, see
+    // updateFixedSize().
+    bool fixedSize = false;
+};
+
+struct WindowStates
+{
+    FramelessWindowStore<const QWindow *, WindowState> windows = {};
+    // The native messages only carry the handle of the window, so the
+    // frameless windows are indexed by it too. It points into "windows",
+    // whose records never move.
+    FramelessWindowStore<HWND, WindowState *> handles = {};
+};
+Q_GLOBAL_STATIC(WindowStates, windowStates)
+
+void removeWindowState(const QWindow *window);
+
+bool isWindowFixedSize(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (window->flags().testFlag(Qt::MSWindowsFixedSizeDialogHint)) {
+        return true;
+    }
+    const QSize minSize = window->minimumSize();
+    const QSize maxSize = window->maximumSize();
+    return !minSize.isEmpty() && !maxSize.isEmpty() && (minSize == maxSize);
+}
+
+// Called by setWindowResizable() and whenever the window is resized, which is
+// what size constraints set by the application lead to anyway.
+void updateFixedSize(WindowState &state)
+{
+    Q_ASSERT(state.window);
+    const bool fixedSize = isWindowFixedSize(state.window);
+    if (state.fixedSize != fixedSize) {
+        state.fixedSize = fixedSize;
+        state.hitTestCache.clear();
+    }
+}
+
+WindowState &getOrCreateWindowState(const QWindow *window)
+{
+    Q_ASSERT(window);
+    bool inserted = false;
+    WindowState &state = windowStates()->windows.findOrInsert(window, &inserted);
+    if (inserted) {
+        state.window = window;
+        state.fixedSize = isWindowFixedSize(window);
+        // A new window may get the same address, it must not inherit
+        // anything from this one.
+        QObject::connect(window, &QObject::destroyed, [window] { removeWindowState(window); });
+    }
+    return state;
+}
+
+void setWindowHandle(WindowState &state, const HWND handle)
+{
+    if (state.handle == handle) {
+        return;
+    }
+    if (state.handle) {
+        windowStates()->handles.remove(state.handle);
+    }
+    state.handle = handle;
+    if (handle) {
+        windowStates()->handles.findOrInsert(handle) = &state;
+    }
+    state.hitTestCache.clear();
+}
+
+TitleBarAreas *getOrCreateTitleBarAreas(QWindow *window)
+{
+    Q_ASSERT(window);
+    WindowState &state = getOrCreateWindowState(window);
+    if (!state.titleBarAreas) {
+        // The areas watch the geometry of the objects, let them die with the
+        // window they belong to.
+        state.titleBarAreas = new TitleBarAreas(window);
+    }
+    return state.titleBarAreas;
+}
+
+const TitleBarAreas *getTitleBarAreas(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const WindowState *state = windowStates()->windows.find(window);
+    return state ? state->titleBarAreas.data() : nullptr;
+}
+
+void clearHitTestCache(const QWindow *window)
+{
+    Q_ASSERT(window);
+    WindowState *state = windowStates()->windows.find(window);
+    if (state) {
+        state->hitTestCache.clear();
+    }
+}
+
+class SystemMetricProvider : public SystemMetricCache::Provider
+{
+public:
+    int getSystemMetric(const SystemMetricCache::Metric metric,
+                        const quint32 dpi,
+                        const bool dpiAware) const override
+    {
+        const auto getSystemMetricsForDpi = [dpi, dpiAware](const int index) -> int {
+            if (coreData()->m_lpGetSystemMetricsForDpi) {
+                return coreData()->m_lpGetSystemMetricsForDpi(index,
+                                                              dpiAware ? dpi
+                                                                       : m_defaultDotsPerInch);
+            }
+            // Only ever in device pixels, scale it back ourselves.
+            const int value = WNEF_EXECUTE_WINAPI_RETURN(GetSystemMetrics, 0, index);
+            const qreal dpr = qreal(dpi) / qreal(m_defaultDotsPerInch);
+            return dpiAware ? value : qRound(value / dpr);
+        };
+        // When dpr = 1.0 (DPI = 96):
+        // SM_CXSIZEFRAME = SM_CYSIZEFRAME = 4px
+        // SM_CXPADDEDBORDER = 4px
+        // SM_CYCAPTION = 23px
+        // Border Width = Border Height = SM_C(X|Y)SIZEFRAME + SM_CXPADDEDBORDER = 8px
+        // Title Bar Height = Border Height + SM_CYCAPTION = 31px
+        // dpr = 1.25 --> Title Bar Height = 38px
+        // dpr = 1.5 --> Title Bar Height = 45px
+        // dpr = 1.75 --> Title Bar Height = 51px
+        switch (metric) {
+        case SystemMetricCache::Metric::BorderWidth:
+            return getSystemMetricsForDpi(SM_CXSIZEFRAME)
+                   + getSystemMetricsForDpi(SM_CXPADDEDBORDER);
+        case SystemMetricCache::Metric::BorderHeight:
+            return getSystemMetricsForDpi(SM_CYSIZEFRAME)
+                   + getSystemMetricsForDpi(SM_CXPADDEDBORDER);
+        case SystemMetricCache::Metric::TitleBarHeight:
+            return getSystemMetricsForDpi(SM_CYCAPTION);
+        }
+        return 0;
+    }
+};
+
+const SystemMetricProvider m_systemMetricProvider;
+
+static_assert(static_cast<int>(WinNativeEventFilter::SystemMetric::TitleBarHeight)
+                  == static_cast<int>(SystemMetricCache::Metric::TitleBarHeight),
+              "The system metrics must be declared in the same order.");
+
+Q_GLOBAL_STATIC_WITH_ARGS(SystemMetricCache, systemMetricCache, (&m_systemMetricProvider))
+
+void removeWindowState(const QWindow *window)
+{
+    Q_ASSERT(window);
+    // The windows may outlive us when the application quits.
+    if (!systemMetricCache.isDestroyed()) {
+        systemMetricCache()->removeWindow(window);
+    }
+    if (windowStates.isDestroyed()) {
+        return;
+    }
+    WindowState *state = windowStates()->windows.find(window);
+    if (state) {
+        setWindowHandle(*state, nullptr);
+        windowStates()->windows.remove(window);
+    }
+}
+
+// Qt may destroy the native window behind a QWindow and create a new one,
+// for example when it needs another surface type. Windows recycles the
+// handles, so the old one must be forgotten right away, and the new one has
+// to be made frameless again.
+class SurfaceWatcher : public QObject
+{
+public:
+    explicit SurfaceWatcher(QWindow *window) : QObject(window), m_window(window)
+    {
+        Q_ASSERT(m_window);
+        m_window->installEventFilter(this);
+    }
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    QWindow *m_window = nullptr;
+};
+
+// Indexed by HitTestEngine::Region.
+const LRESULT m_hitTestResults[] = {HTCLIENT,
+                                    HTCAPTION,
+                                    HTTOP,
+                                    HTBOTTOM,
+                                    HTLEFT,
+                                    HTRIGHT,
+                                    HTTOPLEFT,
+                                    HTTOPRIGHT,
+                                    HTBOTTOMLEFT,
+                                    HTBOTTOMRIGHT,
+                                    // HTBORDER: non-resizable window border.
+                                    HTBORDER};
+static_assert(sizeof(m_hitTestResults) / sizeof(m_hitTestResults[0])
+                  == HitTestEngine::regionCount,
+              "m_hitTestResults doesn't match HitTestEngine::Region.");
 
 void setup()
 {
@@ -819,7 +1010,14 @@ void setup()
 void installHelper(QWindow *window, const bool enable)
 {
     Q_ASSERT(window);
-    window->setProperty(m_framelessMode, enable);
+    WindowState &state = getOrCreateWindowState(window);
+    state.framelessMode = enable;
+    // Creates the native window if it doesn't exist yet.
+    const auto handle = reinterpret_cast<HWND>(window->winId());
+    if (enable && !state.surfaceWatcher) {
+        state.surfaceWatcher = new SurfaceWatcher(window);
+    }
+    setWindowHandle(state, enable ? handle : nullptr);
     const int tbh = enable ? WinNativeEventFilter::getSystemMetric(
                         window, WinNativeEventFilter::SystemMetric::TitleBarHeight, true, true)
                            : 0;
@@ -843,6 +1041,26 @@ void installHelper(QWindow *window, const bool enable)
     triggerFrameChange(window);
 }
 
+bool SurfaceWatcher::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if ((object == m_window) && (event->type() == QEvent::PlatformSurface)) {
+        WindowState *state = windowStates()->windows.find(m_window);
+        if (state && state->framelessMode) {
+            switch (static_cast<QPlatformSurfaceEvent *>(event)->surfaceEventType()) {
+            case QPlatformSurfaceEvent::SurfaceCreated:
+                installHelper(m_window, true);
+                break;
+            case QPlatformSurfaceEvent::SurfaceAboutToBeDestroyed:
+                setWindowHandle(*state, nullptr);
+                break;
+            }
+        }
+    }
+    return QObject::eventFilter(object, event);
+}
+
 } // namespace
 
 WinNativeEventFilter::WinNativeEventFilter() = default;
@@ -864,7 +1082,8 @@ void WinNativeEventFilter::addFramelessWindow(QWindow *window)
 bool WinNativeEventFilter::isWindowFrameless(const QWindow *window)
 {
     Q_ASSERT(window);
-    return window->property(m_framelessMode).toBool();
+    const WindowState *state = windowStates()->windows.find(window);
+    return state && state->framelessMode;
 }
 
 void WinNativeEventFilter::removeFramelessWindow(QWindow *window)
@@ -873,16 +1092,118 @@ void WinNativeEventFilter::removeFramelessWindow(QWindow *window)
     installHelper(window, false);
 }
 
+void WinNativeEventFilter::addIgnoredObject(QWindow *window, QObject *object)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredObject(object);
+}
+
+void WinNativeEventFilter::addIgnoredObjects(QWindow *window, const QObjectList &objects)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredObjects(objects);
+}
+
+void WinNativeEventFilter::removeIgnoredObject(const QWindow *window, const QObject *object)
+{
+    Q_ASSERT(window);
+    WindowState *state = windowStates()->windows.find(window);
+    if (state && state->titleBarAreas) {
+        state->titleBarAreas->removeIgnoredObject(object);
+    }
+}
+
+void WinNativeEventFilter::clearIgnoredObjects(const QWindow *window)
+{
+    Q_ASSERT(window);
+    WindowState *state = windowStates()->windows.find(window);
+    if (state && state->titleBarAreas) {
+        state->titleBarAreas->clearIgnoredObjects();
+    }
+}
+
 void WinNativeEventFilter::setIgnoredObjects(QWindow *window, const QObjectList &objects)
 {
     Q_ASSERT(window);
-    window->setProperty(m_ignoredObjects, QVariant::fromValue(objects));
+    getOrCreateTitleBarAreas(window)->setIgnoredObjects(objects);
 }
 
 QObjectList WinNativeEventFilter::getIgnoredObjects(const QWindow *window)
 {
     Q_ASSERT(window);
-    return qvariant_cast<QObjectList>(window->property(m_ignoredObjects));
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->ignoredObjects() : QObjectList{};
+}
+
+void WinNativeEventFilter::addIgnoredRegion(QWindow *window, const QRegion &region)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredRegion(region);
+}
+
+void WinNativeEventFilter::addIgnoredPath(QWindow *window, const QPainterPath &path)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addIgnoredPath(path);
+}
+
+void WinNativeEventFilter::addDragObject(QWindow *window, QObject *object)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addDragObject(object);
+}
+
+QObjectList WinNativeEventFilter::getDragObjects(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->dragObjects() : QObjectList{};
+}
+
+void WinNativeEventFilter::addDragRect(QWindow *window, const QRectF &rect)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->addDragRect(rect);
+}
+
+void WinNativeEventFilter::setDragAllowListEnabled(QWindow *window, const bool enabled)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setDragAllowListEnabled(enabled);
+}
+
+bool WinNativeEventFilter::isDragAllowListEnabled(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas && areas->isDragAllowListEnabled();
+}
+
+void WinNativeEventFilter::setTitleBarRegionMap(QWindow *window, const TitleBarRegionMap &map)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setRegionMap(map);
+}
+
+void WinNativeEventFilter::setHitTestCallback(QWindow *window,
+                                             const HitTestEngine::Callback &callback)
+{
+    Q_ASSERT(window);
+    getOrCreateTitleBarAreas(window)->setHitTestCallback(callback);
+}
+
+HitTestEngine::Callback WinNativeEventFilter::getHitTestCallback(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->hitTestCallback() : HitTestEngine::Callback{};
+}
+
+TitleBarRegionMap WinNativeEventFilter::getTitleBarRegionMap(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const TitleBarAreas *areas = getTitleBarAreas(window);
+    return areas ? areas->regionMap() : TitleBarRegionMap{};
 }
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -920,10 +1241,13 @@ bool WinNativeEventFilter::nativeEventFilter(const QByteArray &eventType,
         // Anyway, we should skip it in this case.
         return false;
     }
-    const QWindow *window = findWindow(msg->hwnd);
-    if (!window || (window && !window->property(m_framelessMode).toBool())) {
+    // Only the frameless windows are indexed by their handle.
+    WindowState *const *entry = windowStates()->handles.find(msg->hwnd);
+    if (!entry) {
         return false;
     }
+    WindowState *state = *entry;
+    const QWindow *window = state->window;
     switch (msg->message) {
     case WM_NCCALCSIZE: {
         // Windows是根据这个消息的返回值来设置窗口的客户区（窗口中真正显示的内容）
@@ -1288,150 +1612,69 @@ bool WinNativeEventFilter::nativeEventFilter(const QByteArray &eventType,
             break;
         }
 
-        const auto isInSpecificObjects =
-            [](const QPointF &mousePos, const QObjectList &objects, const qreal dpr) -> bool {
-            if (objects.isEmpty()) {
-                return false;
-            }
-            for (auto &&object : qAsConst(objects)) {
-                if (!object) {
-                    continue;
-                }
-                if (!object->isWidgetType() && !object->inherits("QQuickItem")) {
-                    qWarning() << object << "is not a QWidget or QQuickItem!";
-                    continue;
-                }
-                if (!object->property("visible").toBool()) {
-                    qDebug() << "Skipping invisible object" << object;
-                    continue;
-                }
-                const auto mapOriginPointToWindow = [](const QObject *obj) -> QPointF {
-                    Q_ASSERT(obj);
-                    QPointF point = {obj->property("x").toReal(), obj->property("y").toReal()};
-                    for (QObject *parent = obj->parent(); parent; parent = parent->parent()) {
-                        point += {parent->property("x").toReal(), parent->property("y").toReal()};
-                    }
-                    return point;
-                };
-                const QPointF originPoint = mapOriginPointToWindow(object);
-                const qreal width = object->property("width").toReal();
-                const qreal height = object->property("height").toReal();
-                if (QRectF(originPoint.x() * dpr, originPoint.y() * dpr, width * dpr, height * dpr)
-                        .contains(mousePos)) {
-                    return true;
-                }
-            }
-            return false;
-        };
-        const qreal dpr = window->devicePixelRatio();
-        const QPointF globalMouse = QCursor::pos(window->screen()) * dpr;
-        POINT winLocalMouse = {qRound(globalMouse.x()), qRound(globalMouse.y())};
+        // The cursor position comes with the message, in physical pixels.
+        POINT winLocalMouse = {GET_X_LPARAM(msg->lParam), GET_Y_LPARAM(msg->lParam)};
         WNEF_EXECUTE_WINAPI(ScreenToClient, msg->hwnd, &winLocalMouse)
         const QPointF localMouse = {static_cast<qreal>(winLocalMouse.x),
                                     static_cast<qreal>(winLocalMouse.y)};
-        const bool isInIgnoreObjects = isInSpecificObjects(globalMouse,
-                                                           qvariant_cast<QObjectList>(
-                                                               window->property(m_ignoredObjects)),
-                                                           dpr);
-        const int bh = getSystemMetric(window, SystemMetric::BorderHeight, true);
-        const int tbh = getSystemMetric(window, SystemMetric::TitleBarHeight, true);
-        const bool isTitleBar = (localMouse.y() <= tbh) && !isInIgnoreObjects;
-        const bool isTop = localMouse.y() <= bh;
-        if (shouldHaveWindowFrame()) {
-            // This will handle the left, right and bottom parts of the frame
-            // because we didn't change them.
-            const LRESULT originalRet = WNEF_EXECUTE_WINAPI_RETURN(DefWindowProcW,
-                                                                   0,
-                                                                   msg->hwnd,
-                                                                   WM_NCHITTEST,
-                                                                   msg->wParam,
-                                                                   msg->lParam);
-            if (originalRet != HTCLIENT) {
-                *result = originalRet;
-                return true;
+        const qreal dpr = window->devicePixelRatio();
+        // The callback runs on every hit test, we can't know what its result
+        // depends on.
+        const TitleBarAreas *areas = state->titleBarAreas;
+        HitTestEngine::Region region = HitTestEngine::Region::Client;
+        if (areas && areas->hitTestOverride(localMouse / dpr, &region)) {
+            *result = m_hitTestResults[static_cast<int>(region)];
+            return true;
+        }
+        // The size, state, DPI and size constraints of the window clear the
+        // memo when they change (see below and updateFixedSize()), the metric
+        // setters do the same and the title bar areas have their own
+        // generation. Only the points DefWindowProc() leaves to us are ever
+        // remembered, so a hit skips it too.
+        const quint64 generation = areas ? areas->generation() : 0;
+        HitTestCache &cache = state->hitTestCache;
+        if (!cache.lookup(localMouse.x(), localMouse.y(), generation, &region)) {
+            const bool hasWindowFrame = shouldHaveWindowFrame();
+            if (hasWindowFrame) {
+                // This will handle the left, right and bottom parts of the
+                // frame because we didn't change them.
+                const LRESULT originalRet = WNEF_EXECUTE_WINAPI_RETURN(DefWindowProcW,
+                                                                       0,
+                                                                       msg->hwnd,
+                                                                       WM_NCHITTEST,
+                                                                       msg->wParam,
+                                                                       msg->lParam);
+                if (originalRet != HTCLIENT) {
+                    *result = originalRet;
+                    return true;
+                }
             }
-            // At this point, we know that the cursor is inside the client area
-            // so it has to be either the little border at the top of our custom
-            // title bar or the drag bar. Apparently, it must be the drag bar or
-            // the little border at the top which the user can use to move or
-            // resize the window.
-            if (!IsMaximized(msg->hwnd) && isTop) {
-                *result = HTTOP;
-                return true;
+            RECT clientRect = {0, 0, 0, 0};
+            WNEF_EXECUTE_WINAPI(GetClientRect, msg->hwnd, &clientRect)
+            HitTestEngine::Metrics metrics = {};
+            metrics.windowWidth = clientRect.right;
+            metrics.windowHeight = clientRect.bottom;
+            metrics.borderWidth = getSystemMetric(window, SystemMetric::BorderWidth, true);
+            metrics.borderHeight = getSystemMetric(window, SystemMetric::BorderHeight, true);
+            metrics.titleBarHeight = getSystemMetric(window, SystemMetric::TitleBarHeight, true);
+            metrics.maximized = IsMaximized(msg->hwnd);
+            metrics.fixedSize = state->fixedSize;
+            if (hasWindowFrame) {
+                // At this point, we know that the cursor is inside the client
+                // area so it has to be either the little border at the top of
+                // our custom title bar or the drag bar. Apparently, it must be
+                // the drag bar or the little border at the top which the user
+                // can use to move or resize the window.
+                metrics.resizeEdges = Qt::TopEdge;
             }
-            if (isTitleBar) {
-                *result = HTCAPTION;
-                return true;
+            region = HitTestEngine::classify(metrics, localMouse.x(), localMouse.y());
+            if (areas) {
+                region = areas->refine(region, clientRect.right / dpr, localMouse / dpr, dpr);
             }
-            *result = HTCLIENT;
-            return true;
-        } else {
-            const auto getHitTestResult =
-                [msg, isTitleBar, &localMouse, bh, isTop, window]() -> LRESULT {
-                RECT clientRect = {0, 0, 0, 0};
-                WNEF_EXECUTE_WINAPI(GetClientRect, msg->hwnd, &clientRect)
-                const LONG ww = clientRect.right;
-                const LONG wh = clientRect.bottom;
-                const int bw = getSystemMetric(window, SystemMetric::BorderWidth, true);
-                if (IsMaximized(msg->hwnd)) {
-                    if (isTitleBar) {
-                        return HTCAPTION;
-                    }
-                    return HTCLIENT;
-                }
-                const bool isBottom = (localMouse.y() >= (wh - bh));
-                // Make the border a little wider to let the user easy to resize
-                // on corners.
-                const int factor = (isTop || isBottom) ? 2 : 1;
-                const bool isLeft = (localMouse.x() <= (bw * factor));
-                const bool isRight = (localMouse.x() >= (ww - (bw * factor)));
-                const bool fixedSize = [window] {
-                    if (window->flags().testFlag(Qt::MSWindowsFixedSizeDialogHint)) {
-                        return true;
-                    }
-                    const QSize minSize = window->minimumSize();
-                    const QSize maxSize = window->maximumSize();
-                    if (!minSize.isEmpty() && !maxSize.isEmpty() && minSize == maxSize) {
-                        return true;
-                    }
-                    return false;
-                }();
-                const auto getBorderValue = [fixedSize](int value) -> int {
-                    // HTBORDER: non-resizable window border.
-                    return fixedSize ? HTBORDER : value;
-                };
-                if (isTop) {
-                    if (isLeft) {
-                        return getBorderValue(HTTOPLEFT);
-                    }
-                    if (isRight) {
-                        return getBorderValue(HTTOPRIGHT);
-                    }
-                    return getBorderValue(HTTOP);
-                }
-                if (isBottom) {
-                    if (isLeft) {
-                        return getBorderValue(HTBOTTOMLEFT);
-                    }
-                    if (isRight) {
-                        return getBorderValue(HTBOTTOMRIGHT);
-                    }
-                    return getBorderValue(HTBOTTOM);
-                }
-                if (isLeft) {
-                    return getBorderValue(HTLEFT);
-                }
-                if (isRight) {
-                    return getBorderValue(HTRIGHT);
-                }
-                if (isTitleBar) {
-                    return HTCAPTION;
-                }
-                return HTCLIENT;
-            };
-            *result = getHitTestResult();
-            return true;
+            cache.insert(localMouse.x(), localMouse.y(), generation, region);
         }
+        *result = m_hitTestResults[static_cast<int>(region)];
+        return true;
     }
     case WM_SETICON:
     case WM_SETTEXT: {
@@ -1457,6 +1700,22 @@ bool WinNativeEventFilter::nativeEventFilter(const QByteArray &eventType,
         *result = ret;
         return true;
     }
+    case WM_DPICHANGED:
+        systemMetricCache()->invalidate(window);
+        state->hitTestCache.clear();
+        break;
+    case WM_SETTINGCHANGE:
+    case WM_THEMECHANGED:
+        // The frame metrics may have changed for every window.
+        systemMetricCache()->invalidate();
+        windowStates()->windows.forEach(
+            [](const QWindow *, WindowState &windowState) { windowState.hitTestCache.clear(); });
+        break;
+    case WM_SIZE:
+        // The hit test results of this window are no longer valid.
+        state->hitTestCache.clear();
+        updateFixedSize(*state);
+        break;
     default:
         break;
     }
@@ -1466,19 +1725,55 @@ bool WinNativeEventFilter::nativeEventFilter(const QByteArray &eventType,
 void WinNativeEventFilter::setBorderWidth(QWindow *window, const int bw)
 {
     Q_ASSERT(window);
-    window->setProperty(m_borderWidth, bw);
+    getOrCreateWindowState(window);
+    systemMetricCache()->setUserValue(window, SystemMetricCache::Metric::BorderWidth, bw);
+    clearHitTestCache(window);
 }
 
 void WinNativeEventFilter::setBorderHeight(QWindow *window, const int bh)
 {
     Q_ASSERT(window);
-    window->setProperty(m_borderHeight, bh);
+    getOrCreateWindowState(window);
+    systemMetricCache()->setUserValue(window, SystemMetricCache::Metric::BorderHeight, bh);
+    clearHitTestCache(window);
 }
 
 void WinNativeEventFilter::setTitleBarHeight(QWindow *window, const int tbh)
 {
     Q_ASSERT(window);
-    window->setProperty(m_titleBarHeight, tbh);
+    getOrCreateWindowState(window);
+    systemMetricCache()->setUserValue(window, SystemMetricCache::Metric::TitleBarHeight, tbh);
+    clearHitTestCache(window);
+}
+
+void WinNativeEventFilter::setWindowResizable(QWindow *window, const bool resizable)
+{
+    Q_ASSERT(window);
+    window->setFlag(Qt::MSWindowsFixedSizeDialogHint, !resizable);
+    updateFixedSize(getOrCreateWindowState(window));
+}
+
+bool WinNativeEventFilter::isWindowResizable(const QWindow *window)
+{
+    Q_ASSERT(window);
+    return !isWindowFixedSize(window);
+}
+
+quint64 WinNativeEventFilter::getHitTestCacheHits()
+{
+    quint64 hits = 0;
+    windowStates()->windows.forEach(
+        [&hits](const QWindow *, const WindowState &state) { hits += state.hitTestCache.hits(); });
+    return hits;
+}
+
+quint64 WinNativeEventFilter::getHitTestCacheMisses()
+{
+    quint64 misses = 0;
+    windowStates()->windows.forEach([&misses](const QWindow *, const WindowState &state) {
+        misses += state.hitTestCache.misses();
+    });
+    return misses;
 }
 
 int WinNativeEventFilter::getSystemMetric(const QWindow *window,
@@ -1487,72 +1782,16 @@ int WinNativeEventFilter::getSystemMetric(const QWindow *window,
                                           const bool forceSystemValue)
 {
     Q_ASSERT(window);
-    const qreal dpr = dpiAware ? window->devicePixelRatio() : m_defaultDevicePixelRatio;
-    const auto getSystemMetricsForWindow = [dpr](const int index, const bool dpiAware) -> int {
-        if (coreData()->m_lpGetSystemMetricsForDpi) {
-            const quint32 dpi = dpiAware ? qRound(m_defaultDotsPerInch * dpr)
-                                         : m_defaultDotsPerInch;
-            return coreData()->m_lpGetSystemMetricsForDpi(index, dpi);
-        } else {
-            const int value = WNEF_EXECUTE_WINAPI_RETURN(GetSystemMetrics, 0, index);
-            return dpiAware ? value : qRound(value / dpr);
-        }
-    };
-    int ret = 0;
-    switch (metric) {
-    case SystemMetric::BorderWidth: {
-        const int bw = window->property(m_borderWidth).toInt();
-        if ((bw > 0) && !forceSystemValue) {
-            ret = qRound(bw * dpr);
-        } else {
-            const int result_nondpi = getSystemMetricsForWindow(SM_CXSIZEFRAME, false)
-                                      + getSystemMetricsForWindow(SM_CXPADDEDBORDER, false);
-            const int result_dpi = getSystemMetricsForWindow(SM_CXSIZEFRAME, true)
-                                   + getSystemMetricsForWindow(SM_CXPADDEDBORDER, true);
-            const int result = dpiAware ? result_dpi : result_nondpi;
-            ret = result > 0 ? result : qRound(m_defaultBorderWidth * dpr);
-        }
-    } break;
-    case SystemMetric::BorderHeight: {
-        const int bh = window->property(m_borderHeight).toInt();
-        if ((bh > 0) && !forceSystemValue) {
-            ret = qRound(bh * dpr);
-        } else {
-            const int result_nondpi = getSystemMetricsForWindow(SM_CYSIZEFRAME, false)
-                                      + getSystemMetricsForWindow(SM_CXPADDEDBORDER, false);
-            const int result_dpi = getSystemMetricsForWindow(SM_CYSIZEFRAME, true)
-                                   + getSystemMetricsForWindow(SM_CXPADDEDBORDER, true);
-            const int result = dpiAware ? result_dpi : result_nondpi;
-            ret = result > 0 ? result : qRound(m_defaultBorderHeight * dpr);
-        }
-    } break;
-    case SystemMetric::TitleBarHeight: {
-        const int tbh = window->property(m_titleBarHeight).toInt();
-        if ((tbh > 0) && !forceSystemValue) {
-            // Special case: this is the user defined value,
-            // don't change it and just return it untouched.
-            return qRound(tbh * dpr);
-        } else {
-            const int result_nondpi = getSystemMetricsForWindow(SM_CYCAPTION, false);
-            const int result_dpi = getSystemMetricsForWindow(SM_CYCAPTION, true);
-            const int result = dpiAware ? result_dpi : result_nondpi;
-            ret = result > 0 ? result : qRound(m_defaultTitleBarHeight * dpr);
-        }
-    } break;
-    }
-    // When dpr = 1.0 (DPI = 96):
-    // SM_CXSIZEFRAME = SM_CYSIZEFRAME = 4px
-    // SM_CXPADDEDBORDER = 4px
-    // SM_CYCAPTION = 23px
-    // Border Width = Border Height = SM_C(X|Y)SIZEFRAME + SM_CXPADDEDBORDER = 8px
-    // Title Bar Height = Border Height + SM_CYCAPTION = 31px
-    // dpr = 1.25 --> Title Bar Height = 38px
-    // dpr = 1.5 --> Title Bar Height = 45px
-    // dpr = 1.75 --> Title Bar Height = 51px
-    ret += (metric == SystemMetric::TitleBarHeight)
-               ? getSystemMetric(window, SystemMetric::BorderHeight, dpiAware)
-               : 0;
-    return ret;
+    // Makes sure the cached values are dropped together with the window.
+    getOrCreateWindowState(window);
+    // The values are cached for the current DPI of the window.
+    const auto dpi = static_cast<quint32>(
+        qRound(m_defaultDotsPerInch * window->devicePixelRatio()));
+    return systemMetricCache()->getValue(window,
+                                         static_cast<SystemMetricCache::Metric>(metric),
+                                         dpi,
+                                         dpiAware,
+                                         forceSystemValue);
 }
 
 bool WinNativeEventFilter::setBlurEffectEnabled(const QWindow *window,
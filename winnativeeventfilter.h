@@ -25,6 +25,9 @@
 #pragma once
 
 #include "framelesshelper_global.h"
+#include "titlebarregionmap.h"
+#include <QPainterPath>
+#include <QRegion>
 #include <QAbstractNativeEventFilter>
 #include <QColor>
 #include <QObject>
@@ -57,13 +60,45 @@ public:
     static bool isWindowFrameless(const QWindow *window);
     static void removeFramelessWindow(QWindow *window);
 
+    static void addIgnoredObject(QWindow *window, QObject *object);
+    static void addIgnoredObjects(QWindow *window, const QObjectList &objects);
+    static void removeIgnoredObject(const QWindow *window, const QObject *object);
+    static void clearIgnoredObjects(const QWindow *window);
     static void setIgnoredObjects(QWindow *window, const QObjectList &objects);
     static QObjectList getIgnoredObjects(const QWindow *window);
 
+    // Arbitrary ignored shapes, in device independent pixels.
+    static void addIgnoredRegion(QWindow *window, const QRegion &region);
+    static void addIgnoredPath(QWindow *window, const QPainterPath &path);
+
+    // Explicit drag areas, only used in allow-list mode: then nothing but
+    // these areas drags the window.
+    static void addDragObject(QWindow *window, QObject *object);
+    static QObjectList getDragObjects(const QWindow *window);
+    static void addDragRect(QWindow *window, const QRectF &rect);
+
+    static void setDragAllowListEnabled(QWindow *window, const bool enabled);
+    static bool isDragAllowListEnabled(const QWindow *window);
+
+    // Draggable and non-draggable title bar zones, in device independent
+    // pixels. Applied after the drag areas and before the ignored objects.
+    static void setTitleBarRegionMap(QWindow *window, const TitleBarRegionMap &map);
+    static TitleBarRegionMap getTitleBarRegionMap(const QWindow *window);
+
+    // Runs before anything else, "point" is in device independent pixels.
+    // See HitTestEngine::Callback.
+    static void setHitTestCallback(QWindow *window, const HitTestEngine::Callback &callback);
+    static HitTestEngine::Callback getHitTestCallback(const QWindow *window);
+
     static void setBorderWidth(QWindow *window, const int bw);
     static void setBorderHeight(QWindow *window, const int bh);
     static void setTitleBarHeight(QWindow *window, const int tbh);
 
+    // A window is not resizable if it has the MSWindowsFixedSizeDialogHint
+    // flag or if its minimum and maximum sizes are the same.
+    static void setWindowResizable(QWindow *window, const bool resizable);
+    static bool isWindowResizable(const QWindow *window);
+
     static int getSystemMetric(const QWindow *window,
                                const SystemMetric metric,
                                const bool dpiAware,
@@ -96,6 +131,10 @@ public:
     // Query whether the transparency effect is enabled or not.
     static bool isTransparencyEffectEnabled();
 
+    // Statistics of the per-window WM_NCHITTEST memo.
+    static quint64 getHitTestCacheHits();
+    static quint64 getHitTestCacheMisses();
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override;
 #else